@@ -148,11 +148,11 @@ class LinearMapperBase_LPDDR6 : public IAddrMapper {
         m_addr_bits[level] = calc_log2(count[level]);
       }
 
-      // Last (Column) address have the granularity of the prefetch size, 32bit metadata
-      m_addr_bits[m_num_levels - 1] -= calc_log2((m_dram->m_internal_prefetch_size * m_dram->m_organization.dq - 32) / 8);
+      // Last (Column) address have the granularity of the prefetch size, excluding the metadata/ECC bits
+      m_addr_bits[m_num_levels - 1] -= calc_log2((m_dram->m_internal_prefetch_size * m_dram->m_organization.dq - m_dram->m_tx_overhead_bits) / 8);
 
-      // 32bit metadata
-      int tx_bytes = (m_dram->m_internal_prefetch_size * m_dram->m_channel_width - 32) / 8;
+      // Only the data bits of a transaction are addressable
+      int tx_bytes = (m_dram->m_internal_prefetch_size * m_dram->m_channel_width - m_dram->m_tx_overhead_bits) / 8;
       m_tx_offset = calc_log2(tx_bytes);
 
       // Determine where are the row and col bits for ChRaBaRoCo and RoBaRaCoCh
@@ -188,4 +188,65 @@ class ChRaBaRoCo_LPDDR6 final : public LinearMapperBase_LPDDR6, public Implement
     }
 };
 
+
+class RoBaRaCoCh_LPDDR6 final : public LinearMapperBase_LPDDR6, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IAddrMapper, RoBaRaCoCh_LPDDR6, "RoBaRaCoCh_LPDDR6", "Applies a RoBaRaCoCh mapping to the address for LPDDR6 (interleaves the sub-channels).");
+
+  public:
+    void init() override { };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      LinearMapperBase_LPDDR6::setup(frontend, memory_system);
+    }
+
+    void apply(Request& req) override {
+      req.addr_vec.resize(m_num_levels, -1);
+      Addr_t addr = req.addr >> m_tx_offset;
+      req.addr_vec[0] = slice_lower_bits(addr, m_addr_bits[0]);
+      req.addr_vec[m_addr_bits.size() - 1] = slice_lower_bits(addr, m_addr_bits[m_addr_bits.size() - 1]);
+      for (int i = 1; i <= m_row_bits_idx; i++) {
+        req.addr_vec[i] = slice_lower_bits(addr, m_addr_bits[i]);
+      }
+    }
+};
+
+
+/**
+ * @brief     RoBaRaCoBgCh mapping for LPDDR6
+ * @details
+ * Consecutive transactions of a sub-channel rotate through the bank groups before the column, so that
+ * streams can use the short CAS-to-CAS delay of bank-group mode. In 16-bank mode (a single bank group),
+ * the bank bits take the place of the bank-group bits.
+ */
+class RoBaRaCoBgCh_LPDDR6 final : public LinearMapperBase_LPDDR6, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IAddrMapper, RoBaRaCoBgCh_LPDDR6, "RoBaRaCoBgCh_LPDDR6", "Applies a RoBaRaCoBgCh mapping to the address for LPDDR6 (interleaves the sub-channels and bank groups).");
+
+  private:
+    int m_interleave_idx = -1;
+
+  public:
+    void init() override { };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      LinearMapperBase_LPDDR6::setup(frontend, memory_system);
+      m_interleave_idx = m_dram->m_levels("bankgroup");
+      if (m_addr_bits[m_interleave_idx] == 0) {
+        m_interleave_idx = m_dram->m_levels("bank");
+      }
+    }
+
+    void apply(Request& req) override {
+      req.addr_vec.resize(m_num_levels, -1);
+      Addr_t addr = req.addr >> m_tx_offset;
+      req.addr_vec[0] = slice_lower_bits(addr, m_addr_bits[0]);
+      req.addr_vec[m_interleave_idx] = slice_lower_bits(addr, m_addr_bits[m_interleave_idx]);
+      req.addr_vec[m_addr_bits.size() - 1] = slice_lower_bits(addr, m_addr_bits[m_addr_bits.size() - 1]);
+      for (int i = 1; i <= m_row_bits_idx; i++) {
+        if (i != m_interleave_idx) {
+          req.addr_vec[i] = slice_lower_bits(addr, m_addr_bits[i]);
+        }
+      }
+    }
+};
+
 }   // namespace Ramulator
\ No newline at end of file
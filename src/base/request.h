@@ -2,7 +2,10 @@
 #define     RAMULATOR_BASE_REQUEST_H
 
 #include <vector>
-#include <list>
+#include <deque>
+#include <memory>
+#include <iterator>
+#include <functional>
 #include <string>
 
 #include "base/base.h"
@@ -27,6 +30,7 @@ struct Request {
 
   int command = -1;          // The command that need to be issued to progress the request
   int final_command = -1;    // The final command that is needed to finish the request
+  int64_t preq_epoch = -1;   // The device state epoch at which the command was computed
   bool is_stat_updated = false; // Memory controller stats
 
   Clk_t arrive = -1;   // Clock cycle when the request arrive at the memory controller
@@ -39,26 +43,139 @@ struct Request {
   void* m_payload = nullptr;    // Point to a generic payload
 
   Request(Addr_t addr, int type);
-  Request(AddrVec_t addr_vec, int type);
+  Request(const AddrVec_t& addr_vec, int type);
   Request(Addr_t addr, int type, int source_id, std::function<void(Request&)> callback);
 };
 
 
+/**
+ * @brief    A pool of request slots that the request buffers of a controller can share.
+ * @details
+ * Slots have stable indices and are recycled through a free list, so a request is only copied once when
+ * it enters the pool, into the storage of a previously released request. The pool grows on demand (e.g.,
+ * for unbounded maintenance buffers) but never shrinks.
+ */
+struct ReqPool {
+  struct Slot {
+    Request request;
+    int prev = -1;
+    int next = -1;
+    int group = -1;         // The group of the request in a grouped buffer
+    int group_prev = -1;
+    int group_next = -1;
+    uint64_t seq = 0;       // Increases with the position of the request in its buffer
+  };
+  std::deque<Slot> slots;   // A deque keeps the slots in place when the pool grows
+  int free_head = -1;
+
+  int allocate(const Request& request) {
+    if (free_head == -1) {
+      slots.push_back({request});
+      return slots.size() - 1;
+    }
+    int slot_id = free_head;
+    free_head = slots[slot_id].next;
+    slots[slot_id].request = request;
+    return slot_id;
+  }
+
+  void release(int slot_id) {
+    slots[slot_id].request.callback = nullptr;
+    slots[slot_id].next = free_head;
+    free_head = slot_id;
+  }
+};
+
+
+/**
+ * @brief    A FIFO of requests intrusively linked through the slots of a request pool.
+ * @details
+ * Buffers that share a pool (e.g., the read, write and active buffers of a controller) move a request
+ * from one to another by relinking its slot with transfer(). A buffer without a given pool has its own.
+ *
+ * A buffer can additionally be grouped (e.g., by bank), in which case the requests of every group are
+ * also linked in their own FIFO, so that a scheduler can visit the buffer one group at a time.
+ */
 struct ReqBuffer {
-  std::list<Request> buffer;
   size_t max_size = 32;
 
+  struct Group {
+    int head = -1;
+    int tail = -1;
+    size_t size = 0;
+    uint64_t num_linked = 0;    // Number of requests ever added to the group
+    int active_idx = -1;        // Position in the list of non-empty groups
+  };
+
+  class iterator {
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = Request;
+      using difference_type = std::ptrdiff_t;
+      using pointer = Request*;
+      using reference = Request&;
+
+      iterator() = default;
+      iterator(ReqBuffer* buffer, int slot_id): m_buffer(buffer), m_slot_id(slot_id) {};
+
+      Request& operator*() const { return m_buffer->m_pool->slots[m_slot_id].request; }
+      Request* operator->() const { return &m_buffer->m_pool->slots[m_slot_id].request; }
+
+      iterator& operator++() {
+        m_slot_id = m_buffer->m_pool->slots[m_slot_id].next;
+        return *this;
+      }
+      iterator operator++(int) { iterator it = *this; ++(*this); return it; }
+      iterator& operator--() {
+        m_slot_id = (m_slot_id == -1) ? m_buffer->m_tail : m_buffer->m_pool->slots[m_slot_id].prev;
+        return *this;
+      }
+      iterator operator--(int) { iterator it = *this; --(*this); return it; }
+
+      bool operator==(const iterator& other) const { return m_slot_id == other.m_slot_id && m_buffer == other.m_buffer; }
+
+      int slot_id() const { return m_slot_id; }
+
+    private:
+      ReqBuffer* m_buffer = nullptr;
+      int m_slot_id = -1;
+  };
+
+  ReqBuffer(): m_own_pool(std::make_unique<ReqPool>()), m_pool(m_own_pool.get()) {};
+  explicit ReqBuffer(ReqPool* pool): m_pool(pool) {};
+
+  iterator begin() { return iterator(this, m_head); };
+  iterator end() { return iterator(this, -1); };
 
-  using iterator = std::list<Request>::iterator;
-  iterator begin() { return buffer.begin(); };
-  iterator end() { return buffer.end(); };
+  size_t size() const { return m_size; }
 
+  /**
+   * @brief    Groups the requests with group_of, which maps a request to its group in [0, num_groups).
+   * @details
+   * Requests already in the buffer are grouped right away, and any later one when it is added.
+   */
+  void set_groups(int num_groups, std::function<int(const Request&)> group_of) {
+    m_groups.assign(num_groups, Group());
+    m_active_groups.clear();
+    m_group_of = std::move(group_of);
+    for (int slot_id = m_head; slot_id != -1; slot_id = m_pool->slots[slot_id].next) {
+      link_group(slot_id);
+    }
+  }
+
+  bool is_grouped() const { return bool(m_group_of); }
 
-  size_t size() const { return buffer.size(); }
+  const Group& get_group(int group) const { return m_groups[group]; }
+  const std::vector<int>& get_active_groups() const { return m_active_groups; }
+
+  iterator at(int slot_id) { return iterator(this, slot_id); }
+  int get_group_next(int slot_id) const { return m_pool->slots[slot_id].group_next; }
+  int get_group_prev(int slot_id) const { return m_pool->slots[slot_id].group_prev; }
+  uint64_t get_seq(int slot_id) const { return m_pool->slots[slot_id].seq; }
 
   bool enqueue(const Request& request) {
-    if (buffer.size() < max_size) {
-      buffer.push_back(request);
+    if (m_size < max_size) {
+      link_back(m_pool->allocate(request));
       return true;
     } else {
       return false;
@@ -66,8 +183,117 @@ struct ReqBuffer {
   }
 
   void remove(iterator it) {
-    buffer.erase(it);
+    unlink(it.slot_id());
+    m_pool->release(it.slot_id());
+  }
+
+  /**
+   * @brief    Moves the request to the back of another buffer, without copying it if both share a pool.
+   * @return   false if the other buffer is full.
+   */
+  bool transfer(iterator it, ReqBuffer& buffer) {
+    if (buffer.m_pool != m_pool) {
+      if (!buffer.enqueue(*it)) {
+        return false;
+      }
+      remove(it);
+      return true;
+    }
+    if (buffer.m_size >= buffer.max_size) {
+      return false;
+    }
+    unlink(it.slot_id());
+    buffer.link_back(it.slot_id());
+    return true;
   }
+
+  private:
+    std::unique_ptr<ReqPool> m_own_pool;
+    ReqPool* m_pool = nullptr;
+    int m_head = -1;
+    int m_tail = -1;
+    size_t m_size = 0;
+    uint64_t m_num_linked = 0;
+
+    std::vector<Group> m_groups;
+    std::vector<int> m_active_groups;
+    std::function<int(const Request&)> m_group_of;
+
+    void link_back(int slot_id) {
+      auto& slot = m_pool->slots[slot_id];
+      slot.prev = m_tail;
+      slot.next = -1;
+      slot.seq = m_num_linked++;
+      if (m_tail == -1) {
+        m_head = slot_id;
+      } else {
+        m_pool->slots[m_tail].next = slot_id;
+      }
+      m_tail = slot_id;
+      m_size++;
+      if (m_group_of) {
+        link_group(slot_id);
+      }
+    }
+
+    void link_group(int slot_id) {
+      auto& slot = m_pool->slots[slot_id];
+      slot.group = m_group_of(slot.request);
+      Group& group = m_groups[slot.group];
+      slot.group_prev = group.tail;
+      slot.group_next = -1;
+      if (group.tail == -1) {
+        group.head = slot_id;
+        group.active_idx = m_active_groups.size();
+        m_active_groups.push_back(slot.group);
+      } else {
+        m_pool->slots[group.tail].group_next = slot_id;
+      }
+      group.tail = slot_id;
+      group.size++;
+      group.num_linked++;
+    }
+
+    void unlink_group(int slot_id) {
+      auto& slot = m_pool->slots[slot_id];
+      Group& group = m_groups[slot.group];
+      if (slot.group_prev == -1) {
+        group.head = slot.group_next;
+      } else {
+        m_pool->slots[slot.group_prev].group_next = slot.group_next;
+      }
+      if (slot.group_next == -1) {
+        group.tail = slot.group_prev;
+      } else {
+        m_pool->slots[slot.group_next].group_prev = slot.group_prev;
+      }
+      if (--group.size == 0) {
+        // Swap the group out of the list of non-empty groups
+        int last_group = m_active_groups.back();
+        m_active_groups[group.active_idx] = last_group;
+        m_groups[last_group].active_idx = group.active_idx;
+        m_active_groups.pop_back();
+        group.active_idx = -1;
+      }
+    }
+
+    void unlink(int slot_id) {
+      if (m_group_of) {
+        unlink_group(slot_id);
+      }
+      auto& slot = m_pool->slots[slot_id];
+      if (slot.prev == -1) {
+        m_head = slot.next;
+      } else {
+        m_pool->slots[slot.prev].next = slot.next;
+      }
+      if (slot.next == -1) {
+        m_tail = slot.prev;
+      } else {
+        m_pool->slots[slot.next].prev = slot.prev;
+      }
+      m_size--;
+    }
 };
 
 }        // namespace Ramulator
@@ -2,6 +2,9 @@
 #define     RAMULATOR_BASE_TYPE_H
 
 #include <vector>
+#include <array>
+#include <initializer_list>
+#include <stdexcept>
 #include <unordered_map>
 #include <string>
 #include <type_traits>
@@ -9,9 +12,81 @@
 
 namespace Ramulator {
 
-using Clk_t     = int64_t;            // Clock cycle
-using Addr_t    = int64_t;            // Plain address as seen by the OS
-using AddrVec_t = std::vector<int>;   // Device address vector as is sent to the device from the controller
+/**
+ * @brief     Vector with a fixed capacity that keeps its elements inline
+ * @details
+ * Behaves like a std::vector that never grows beyond N elements, so constructing and copying it
+ * never touches the heap.
+ *
+ */
+template<typename T, size_t N>
+class StaticVector {
+  private:
+    std::array<T, N> m_elems {};
+    size_t m_size = 0;
+
+  public:
+    StaticVector() = default;
+    explicit StaticVector(size_t size, const T& value = T()) { resize(size, value); };
+    StaticVector(std::initializer_list<T> elems) {
+      check_capacity(elems.size());
+      for (const T& elem : elems) {
+        m_elems[m_size++] = elem;
+      }
+    };
+
+    static constexpr size_t capacity() { return N; };
+    size_t size() const { return m_size; };
+    bool empty() const { return m_size == 0; };
+
+    T& operator[](size_t i) { return m_elems[i]; };
+    const T& operator[](size_t i) const { return m_elems[i]; };
+
+    T* data() { return m_elems.data(); };
+    const T* data() const { return m_elems.data(); };
+    T* begin() { return m_elems.data(); };
+    const T* begin() const { return m_elems.data(); };
+    T* end() { return m_elems.data() + m_size; };
+    const T* end() const { return m_elems.data() + m_size; };
+
+    void resize(size_t size, const T& value = T()) {
+      check_capacity(size);
+      for (size_t i = m_size; i < size; i++) {
+        m_elems[i] = value;
+      }
+      m_size = size;
+    };
+
+    void push_back(const T& value) {
+      check_capacity(m_size + 1);
+      m_elems[m_size++] = value;
+    };
+
+    void clear() { m_size = 0; };
+
+    bool operator==(const StaticVector& other) const {
+      if (m_size != other.m_size) {
+        return false;
+      }
+      for (size_t i = 0; i < m_size; i++) {
+        if (m_elems[i] != other.m_elems[i]) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+  private:
+    static void check_capacity(size_t size) {
+      if (size > N) {
+        throw std::length_error("StaticVector capacity exceeded!");
+      }
+    };
+};
+
+using Clk_t     = int64_t;                  // Clock cycle
+using Addr_t    = int64_t;                  // Plain address as seen by the OS
+using AddrVec_t = StaticVector<int, 8>;     // Device address vector as is sent to the device from the controller
 
 template<typename T>
 using Registry_t = std::unordered_map<std::string, T>;
@@ -5,6 +5,7 @@
 #include <vector>
 #include <map>
 #include <functional>
+#include <limits>
 
 #include "base/base.h"
 #include "dram/spec.h"
@@ -23,6 +24,7 @@ class IDRAM : public Clocked<IDRAM> {
     SpecDef m_levels;                   // Definition (i.e., names and ids) of the levels in the hierarchy
     Organization m_organization;        // The organization of the device (density, dq, levels)
     int m_channel_width = -1;           // Channel width (should be set by the implementation's config)
+    int m_tx_overhead_bits = 0;         // Bits of every transaction that do not carry data (e.g., metadata or ECC)
 
 
   /************************************************
@@ -55,6 +57,7 @@ class IDRAM : public Clocked<IDRAM> {
     SpecLUT<int> m_timing_vals{m_timings};  // The LUT of the values for each timing constraints
 
     TimingCons m_timing_cons;           // The actual timing constraints used by Ramulator's DRAM model
+    CompiledTimingCons m_timing_table;  // The timing constraints compiled by populate_timingcons() for update_timing()
 
     Clk_t m_read_latency = -1;          // Number of cycles needed between issuing RD command and receiving data.
 
@@ -99,6 +102,17 @@ class IDRAM : public Clocked<IDRAM> {
      */
     virtual int get_preq_command(int command, const AddrVec_t& addr_vec) = 0;
 
+    /**
+     * @brief    Returns the address that the prequisite command of the given command is issued to
+     * @details
+     * A prerequisite command usually goes to the address of the command it prepares (e.g., the PRE before
+     * an ACT). Devices whose maintenance commands need a command at another node (e.g., closing the partner
+     * bank of an LPDDR6 per-bank refresh) override this. The controllers ask for the requests in their
+     * priority buffers and for every command they issue.
+     * 
+     */
+    virtual AddrVec_t get_preq_addr_vec(int command, int preq_command, const AddrVec_t& addr_vec) { return addr_vec; };
+
     /**
      * @brief     Checks whether the device is ready to accept the given command.
      * @details
@@ -108,6 +122,26 @@ class IDRAM : public Clocked<IDRAM> {
      */
     virtual bool check_ready(int command, const AddrVec_t& addr_vec) = 0;
 
+    /**
+     * @brief     Returns the earliest cycle at which the device can accept the given command.
+     * @details
+     * Given a command and its address, this function should return the earliest clock cycle that
+     * satisfies all timing constraints given the commands issued so far (it can be in the past).
+     * This lets the controller reason about when a request becomes ready, not just whether.
+     * 
+     */
+    virtual Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) = 0;
+
+    /**
+     * @brief     Returns the earliest cycle at which the command bus of the channel can take a new command.
+     * @details
+     * Devices whose commands occupy the command bus for several cycles (e.g., the 2-cycle commands of LPDDR6)
+     * reserve the bus when a command is issued, so the controller does not need to schedule until it is free.
+     * By default, every command takes a single cycle and the bus is always free.
+     * 
+     */
+    virtual Clk_t get_command_bus_ready_clk(int channel_id) { return m_clk; };
+
     /**
      * @brief     Checks whether the command will result in a rowbuffer hit
      * @details
@@ -123,6 +157,41 @@ class IDRAM : public Clocked<IDRAM> {
      */
     virtual bool check_node_open(int command, const AddrVec_t& addr_vec) = 0;
 
+    /**
+     * @brief     Checks whether the rank of the address is in self-refresh
+     * @details
+     * A rank in self-refresh refreshes itself, so the refresh manager does not need to send it refreshes.
+     * Devices without a self-refresh state never are.
+     * 
+     */
+    virtual bool check_self_refresh(const AddrVec_t& addr_vec) { return false; };
+
+    /**
+     * @brief     Returns a counter that changes whenever the prerequisites of commands to the address may change
+     * @details
+     * A prerequisite command computed at the same epoch is still valid, so the controller does not have to
+     * query it again. The epoch covers the nodes on the path to the address (e.g., its rank and bank) and
+     * below it. A device whose prerequisites read other nodes (e.g., the partner bank of an LPDDR6 per-bank
+     * refresh) has to fold their epochs in as well. Changes that happen with time rather than with a command
+     * have to be recorded when the device ticks, as the epoch only reads the device state. Devices that do
+     * not track their state changes return -1, i.e., never cache.
+     * 
+     */
+    virtual int64_t get_state_epoch(const AddrVec_t& addr_vec) { return -1; };
+
+    /**
+     * @brief     Updates the prerequisite command of the request unless its state epoch is unchanged
+     * 
+     */
+    int update_preq_command(Request& req) {
+      int64_t epoch = get_state_epoch(req.addr_vec);
+      if (epoch == -1 || epoch != req.preq_epoch) {
+        req.command = get_preq_command(req.final_command, req.addr_vec);
+        req.preq_epoch = epoch;
+      }
+      return req.command;
+    };
+
     /**
      * @brief     An universal interface for the host to change DRAM configurations on the fly
      * @details
@@ -133,6 +202,29 @@ class IDRAM : public Clocked<IDRAM> {
      */
     virtual void notify(std::string_view key, uint64_t value) {};
 
+    /**
+     * @brief     Returns the earliest cycle at which ticking the device can change its state
+     * @details
+     * Without new commands, ticks before this cycle only advance the clock. By default, the only
+     * such events are the pending future actions (e.g., the end of a refresh).
+     * 
+     */
+    virtual Clk_t get_next_event_clk() {
+      Clk_t next_clk = std::numeric_limits<Clk_t>::max();
+      for (const auto& future_action : m_future_actions) {
+        if (future_action.clk > m_clk) {
+          next_clk = std::min(next_clk, future_action.clk);
+        }
+      }
+      return next_clk;
+    };
+
+    /**
+     * @brief     Advances the clock to the given cycle, which must be before get_next_event_clk()
+     * 
+     */
+    virtual void fast_forward(Clk_t clk) { m_clk = clk; };
+
     /**
      * @brief     
     */
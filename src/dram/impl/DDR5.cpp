@@ -177,11 +177,14 @@ class DDR5 : public IDRAM, public Implementation {
     };
     std::vector<Node*> m_channels;
     
-    FuncMatrix<ActionFunc_t<Node>>  m_actions;
-    FuncMatrix<PreqFunc_t<Node>>    m_preqs;
-    FuncMatrix<RowhitFunc_t<Node>>  m_rowhits;
-    FuncMatrix<RowopenFunc_t<Node>> m_rowopens;
-    FuncMatrix<PowerFunc_t<Node>>   m_powers;
+    template<typename F>
+    using FuncTable_t = FuncTable<F, m_levels.size(), m_commands.size()>;
+    // Built at compile time below the class, so that the node recursion indexes them at a fixed address (see FuncTable)
+    static const FuncTable_t<ActionFuncPtr_t<Node>>   m_actions;
+    static const FuncTable_t<PreqFuncPtr_t<Node>>     m_preqs;
+    static const FuncTable_t<RowhitFuncPtr_t<Node>>   m_rowhits;
+    static const FuncTable_t<RowopenFuncPtr_t<Node>>  m_rowopens;
+    static const FuncTable_t<PowerFuncPtr_t<Node>>    m_powers;
 
     double s_total_rfm_energy = 0.0;
 
@@ -212,11 +215,6 @@ class DDR5 : public IDRAM, public Implementation {
       RAMULATOR_DECLARE_SPECS();
       set_organization();
       set_timing_vals();
-
-      set_actions();
-      set_preqs();
-      set_rowhits();
-      set_rowopens();
       set_powers();
       
       create_nodes();
@@ -301,6 +299,11 @@ class DDR5 : public IDRAM, public Implementation {
       return m_channels[channel_id]->check_ready(command, addr_vec, m_clk);
     };
 
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      return m_channels[channel_id]->get_ready_clk(command, addr_vec);
+    };
+
     bool check_rowbuffer_hit(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
       return m_channels[channel_id]->check_rowbuffer_hit(command, addr_vec, m_clk);
@@ -311,6 +314,11 @@ class DDR5 : public IDRAM, public Implementation {
       return m_channels[channel_id]->check_node_open(command, addr_vec, m_clk);
     };
 
+    int64_t get_state_epoch(const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      return m_channels[channel_id]->get_state_epoch(addr_vec);
+    };
+
   private:
     void set_organization() {
       // Channel width
@@ -581,71 +589,6 @@ class DDR5 : public IDRAM, public Implementation {
 
     };
 
-    void set_actions() {
-      m_actions.resize(m_levels.size(), std::vector<ActionFunc_t<Node>>(m_commands.size()));
-
-      // Rank Actions
-      m_actions[m_levels["rank"]][m_commands["PREA"]] = Lambdas::Action::Rank::PREab<DDR5>;
-      m_actions[m_levels["rank"]][m_commands["REFab"]] = Lambdas::Action::Rank::REFab<DDR5>;
-      m_actions[m_levels["rank"]][m_commands["REFab_end"]] = Lambdas::Action::Rank::REFab_end<DDR5>;
-      m_actions[m_levels["rank"]][m_commands["RFMab"]] = Lambdas::Action::Rank::REFab<DDR5>;
-      m_actions[m_levels["rank"]][m_commands["RFMab_end"]] = Lambdas::Action::Rank::REFab_end<DDR5>;
-      m_actions[m_levels["rank"]][m_commands["DRFMab"]] = Lambdas::Action::Rank::REFab<DDR5>;
-      m_actions[m_levels["rank"]][m_commands["DRFMab_end"]] = Lambdas::Action::Rank::REFab_end<DDR5>;
-      
-      // Same-Bank Actions.
-      m_actions[m_levels["bankgroup"]][m_commands["PREsb"]] = Lambdas::Action::BankGroup::PREsb<DDR5>;
-
-      // We call update_timing for the banks in other BGs here
-      m_actions[m_levels["bankgroup"]][m_commands["REFsb"]]  = Lambdas::Action::BankGroup::REFsb<DDR5>;
-      m_actions[m_levels["bankgroup"]][m_commands["REFsb_end"]]  = Lambdas::Action::BankGroup::REFsb_end<DDR5>;
-      m_actions[m_levels["bankgroup"]][m_commands["RFMsb"]]  = Lambdas::Action::BankGroup::REFsb<DDR5>;
-      m_actions[m_levels["bankgroup"]][m_commands["RFMsb_end"]]  = Lambdas::Action::BankGroup::REFsb_end<DDR5>;
-      m_actions[m_levels["bankgroup"]][m_commands["DRFMsb"]] = Lambdas::Action::BankGroup::REFsb<DDR5>;
-      m_actions[m_levels["bankgroup"]][m_commands["DRFMsb_end"]] = Lambdas::Action::BankGroup::REFsb_end<DDR5>;
-
-      // Bank actions
-      m_actions[m_levels["bank"]][m_commands["ACT"]] = Lambdas::Action::Bank::ACT<DDR5>;
-      m_actions[m_levels["bank"]][m_commands["PRE"]] = Lambdas::Action::Bank::PRE<DDR5>;
-      m_actions[m_levels["bank"]][m_commands["RDA"]] = Lambdas::Action::Bank::PRE<DDR5>;
-      m_actions[m_levels["bank"]][m_commands["WRA"]] = Lambdas::Action::Bank::PRE<DDR5>;
-    };
-
-    void set_preqs() {
-      m_preqs.resize(m_levels.size(), std::vector<PreqFunc_t<Node>>(m_commands.size()));
-
-      // Rank Preqs
-      m_preqs[m_levels["rank"]][m_commands["REFab"]]  = Lambdas::Preq::Rank::RequireAllBanksClosed<DDR5>;
-      m_preqs[m_levels["rank"]][m_commands["RFMab"]]  = Lambdas::Preq::Rank::RequireAllBanksClosed<DDR5>;
-      m_preqs[m_levels["rank"]][m_commands["DRFMab"]] = Lambdas::Preq::Rank::RequireAllBanksClosed<DDR5>;
-
-      // Same-Bank Preqs.
-      m_preqs[m_levels["rank"]][m_commands["REFsb"]]  = Lambdas::Preq::Rank::RequireSameBanksClosed<DDR5>;
-      m_preqs[m_levels["rank"]][m_commands["RFMsb"]]  = Lambdas::Preq::Rank::RequireSameBanksClosed<DDR5>;
-      m_preqs[m_levels["rank"]][m_commands["DRFMsb"]] = Lambdas::Preq::Rank::RequireSameBanksClosed<DDR5>;
-
-      // Bank Preqs
-      m_preqs[m_levels["bank"]][m_commands["RD"]] = Lambdas::Preq::Bank::RequireRowOpen<DDR5>;
-      m_preqs[m_levels["bank"]][m_commands["WR"]] = Lambdas::Preq::Bank::RequireRowOpen<DDR5>;
-      m_preqs[m_levels["bank"]][m_commands["ACT"]] = Lambdas::Preq::Bank::RequireRowOpen<DDR5>;
-      m_preqs[m_levels["bank"]][m_commands["PRE"]] = Lambdas::Preq::Bank::RequireBankClosed<DDR5>;
-    };
-
-    void set_rowhits() {
-      m_rowhits.resize(m_levels.size(), std::vector<RowhitFunc_t<Node>>(m_commands.size()));
-
-      m_rowhits[m_levels["bank"]][m_commands["RD"]] = Lambdas::RowHit::Bank::RDWR<DDR5>;
-      m_rowhits[m_levels["bank"]][m_commands["WR"]] = Lambdas::RowHit::Bank::RDWR<DDR5>;
-    }
-
-
-    void set_rowopens() {
-      m_rowopens.resize(m_levels.size(), std::vector<RowhitFunc_t<Node>>(m_commands.size()));
-
-      m_rowopens[m_levels["bank"]][m_commands["RD"]] = Lambdas::RowOpen::Bank::RDWR<DDR5>;
-      m_rowopens[m_levels["bank"]][m_commands["WR"]] = Lambdas::RowOpen::Bank::RDWR<DDR5>;
-    }
-
     void set_powers() {
       
       m_drampower_enable = param<bool>("drampower_enable").default_val(false);
@@ -686,32 +629,6 @@ class DDR5 : public IDRAM, public Implementation {
         }
       }
 
-      m_powers.resize(m_levels.size(), std::vector<PowerFunc_t<Node>>(m_commands.size()));
-
-      m_powers[m_levels["bank"]][m_commands["ACT"]] = Lambdas::Power::Bank::ACT<DDR5>;
-      m_powers[m_levels["bank"]][m_commands["PRE"]] = Lambdas::Power::Bank::PRE<DDR5>;
-      m_powers[m_levels["bank"]][m_commands["RD"]]  = Lambdas::Power::Bank::RD<DDR5>;
-      m_powers[m_levels["bank"]][m_commands["WR"]]  = Lambdas::Power::Bank::WR<DDR5>;
-
-      // m_powers[m_levels["rank"]][m_commands["REFsb"]] = Lambdas::Power::Rank::REFsb<DDR5>;
-      // m_powers[m_levels["rank"]][m_commands["REFsb_end"]] = Lambdas::Power::Rank::REFsb_end<DDR5>;
-      m_powers[m_levels["rank"]][m_commands["RFMsb"]] = Lambdas::Power::Rank::RFMsb<DDR5>;
-      m_powers[m_levels["rank"]][m_commands["RFMsb_end"]] = Lambdas::Power::Rank::RFMsb_end<DDR5>;
-      // m_powers[m_levels["rank"]][m_commands["DRFMsb"]] = Lambdas::Power::Rank::REFsb<DDR5>;
-      // m_powers[m_levels["rank"]][m_commands["DRFMsb_end"]] = Lambdas::Power::Rank::REFsb_end<DDR5>;
-
-      m_powers[m_levels["rank"]][m_commands["ACT"]] = Lambdas::Power::Rank::ACT<DDR5>;
-      m_powers[m_levels["rank"]][m_commands["PRE"]] = Lambdas::Power::Rank::PRE<DDR5>;
-      m_powers[m_levels["rank"]][m_commands["PREA"]] = Lambdas::Power::Rank::PREA<DDR5>;
-      m_powers[m_levels["rank"]][m_commands["REFab"]] = Lambdas::Power::Rank::REFab<DDR5>;
-      m_powers[m_levels["rank"]][m_commands["REFab_end"]] = Lambdas::Power::Rank::REFab_end<DDR5>;
-      // m_powers[m_levels["rank"]][m_commands["RFMab"]] = Lambdas::Power::Rank::REFab<DDR5>;
-      // m_powers[m_levels["rank"]][m_commands["RFMab_end"]] = Lambdas::Power::Rank::REFab_end<DDR5>;
-      // m_powers[m_levels["rank"]][m_commands["DRFMab"]] = Lambdas::Power::Rank::REFab<DDR5>;
-      // m_powers[m_levels["rank"]][m_commands["DRFMab_end"]] = Lambdas::Power::Rank::REFab_end<DDR5>;
-
-      m_powers[m_levels["rank"]][m_commands["PREsb"]] = Lambdas::Power::Rank::PREsb<DDR5>;
-
       // register stats
       register_stat(s_total_background_energy).name("total_background_energy");
       register_stat(s_total_cmd_energy).name("total_cmd_energy");
@@ -808,4 +725,99 @@ class DDR5 : public IDRAM, public Implementation {
 };
 
 
+/************************************************
+ *     Node Actions, Preqs, Row Hits/Opens
+ ***********************************************/
+constexpr DDR5::FuncTable_t<ActionFuncPtr_t<DDR5::Node>> DDR5::m_actions = [] {
+  FuncTable_t<ActionFuncPtr_t<Node>> t;
+  // Rank Actions
+  t[m_levels["rank"]][m_commands["PREA"]] = Lambdas::Action::Rank::PREab<DDR5>;
+  t[m_levels["rank"]][m_commands["REFab"]] = Lambdas::Action::Rank::REFab<DDR5>;
+  t[m_levels["rank"]][m_commands["REFab_end"]] = Lambdas::Action::Rank::REFab_end<DDR5>;
+  t[m_levels["rank"]][m_commands["RFMab"]] = Lambdas::Action::Rank::REFab<DDR5>;
+  t[m_levels["rank"]][m_commands["RFMab_end"]] = Lambdas::Action::Rank::REFab_end<DDR5>;
+  t[m_levels["rank"]][m_commands["DRFMab"]] = Lambdas::Action::Rank::REFab<DDR5>;
+  t[m_levels["rank"]][m_commands["DRFMab_end"]] = Lambdas::Action::Rank::REFab_end<DDR5>;
+  
+  // Same-Bank Actions.
+  t[m_levels["bankgroup"]][m_commands["PREsb"]] = Lambdas::Action::BankGroup::PREsb<DDR5>;
+
+  // We call update_timing for the banks in other BGs here
+  t[m_levels["bankgroup"]][m_commands["REFsb"]]  = Lambdas::Action::BankGroup::REFsb<DDR5>;
+  t[m_levels["bankgroup"]][m_commands["REFsb_end"]]  = Lambdas::Action::BankGroup::REFsb_end<DDR5>;
+  t[m_levels["bankgroup"]][m_commands["RFMsb"]]  = Lambdas::Action::BankGroup::REFsb<DDR5>;
+  t[m_levels["bankgroup"]][m_commands["RFMsb_end"]]  = Lambdas::Action::BankGroup::REFsb_end<DDR5>;
+  t[m_levels["bankgroup"]][m_commands["DRFMsb"]] = Lambdas::Action::BankGroup::REFsb<DDR5>;
+  t[m_levels["bankgroup"]][m_commands["DRFMsb_end"]] = Lambdas::Action::BankGroup::REFsb_end<DDR5>;
+
+  // Bank actions
+  t[m_levels["bank"]][m_commands["ACT"]] = Lambdas::Action::Bank::ACT<DDR5>;
+  t[m_levels["bank"]][m_commands["PRE"]] = Lambdas::Action::Bank::PRE<DDR5>;
+  t[m_levels["bank"]][m_commands["RDA"]] = Lambdas::Action::Bank::PRE<DDR5>;
+  t[m_levels["bank"]][m_commands["WRA"]] = Lambdas::Action::Bank::PRE<DDR5>;
+  return t;
+}();
+
+constexpr DDR5::FuncTable_t<PreqFuncPtr_t<DDR5::Node>> DDR5::m_preqs = [] {
+  FuncTable_t<PreqFuncPtr_t<Node>> t;
+  // Rank Preqs
+  t[m_levels["rank"]][m_commands["REFab"]]  = Lambdas::Preq::Rank::RequireAllBanksClosed<DDR5>;
+  t[m_levels["rank"]][m_commands["RFMab"]]  = Lambdas::Preq::Rank::RequireAllBanksClosed<DDR5>;
+  t[m_levels["rank"]][m_commands["DRFMab"]] = Lambdas::Preq::Rank::RequireAllBanksClosed<DDR5>;
+
+  // Same-Bank Preqs.
+  t[m_levels["rank"]][m_commands["REFsb"]]  = Lambdas::Preq::Rank::RequireSameBanksClosed<DDR5>;
+  t[m_levels["rank"]][m_commands["RFMsb"]]  = Lambdas::Preq::Rank::RequireSameBanksClosed<DDR5>;
+  t[m_levels["rank"]][m_commands["DRFMsb"]] = Lambdas::Preq::Rank::RequireSameBanksClosed<DDR5>;
+
+  // Bank Preqs
+  t[m_levels["bank"]][m_commands["RD"]] = Lambdas::Preq::Bank::RequireRowOpen<DDR5>;
+  t[m_levels["bank"]][m_commands["WR"]] = Lambdas::Preq::Bank::RequireRowOpen<DDR5>;
+  t[m_levels["bank"]][m_commands["ACT"]] = Lambdas::Preq::Bank::RequireRowOpen<DDR5>;
+  t[m_levels["bank"]][m_commands["PRE"]] = Lambdas::Preq::Bank::RequireBankClosed<DDR5>;
+  return t;
+}();
+
+constexpr DDR5::FuncTable_t<RowhitFuncPtr_t<DDR5::Node>> DDR5::m_rowhits = [] {
+  FuncTable_t<RowhitFuncPtr_t<Node>> t;
+  t[m_levels["bank"]][m_commands["RD"]] = Lambdas::RowHit::Bank::RDWR<DDR5>;
+  t[m_levels["bank"]][m_commands["WR"]] = Lambdas::RowHit::Bank::RDWR<DDR5>;
+  return t;
+}();
+
+constexpr DDR5::FuncTable_t<RowopenFuncPtr_t<DDR5::Node>> DDR5::m_rowopens = [] {
+  FuncTable_t<RowopenFuncPtr_t<Node>> t;
+  t[m_levels["bank"]][m_commands["RD"]] = Lambdas::RowOpen::Bank::RDWR<DDR5>;
+  t[m_levels["bank"]][m_commands["WR"]] = Lambdas::RowOpen::Bank::RDWR<DDR5>;
+  return t;
+}();
+
+constexpr DDR5::FuncTable_t<PowerFuncPtr_t<DDR5::Node>> DDR5::m_powers = [] {
+  FuncTable_t<PowerFuncPtr_t<Node>> t;
+  t[m_levels["bank"]][m_commands["ACT"]] = Lambdas::Power::Bank::ACT<DDR5>;
+  t[m_levels["bank"]][m_commands["PRE"]] = Lambdas::Power::Bank::PRE<DDR5>;
+  t[m_levels["bank"]][m_commands["RD"]]  = Lambdas::Power::Bank::RD<DDR5>;
+  t[m_levels["bank"]][m_commands["WR"]]  = Lambdas::Power::Bank::WR<DDR5>;
+
+  // t[m_levels["rank"]][m_commands["REFsb"]] = Lambdas::Power::Rank::REFsb<DDR5>;
+  // t[m_levels["rank"]][m_commands["REFsb_end"]] = Lambdas::Power::Rank::REFsb_end<DDR5>;
+  t[m_levels["rank"]][m_commands["RFMsb"]] = Lambdas::Power::Rank::RFMsb<DDR5>;
+  t[m_levels["rank"]][m_commands["RFMsb_end"]] = Lambdas::Power::Rank::RFMsb_end<DDR5>;
+  // t[m_levels["rank"]][m_commands["DRFMsb"]] = Lambdas::Power::Rank::REFsb<DDR5>;
+  // t[m_levels["rank"]][m_commands["DRFMsb_end"]] = Lambdas::Power::Rank::REFsb_end<DDR5>;
+
+  t[m_levels["rank"]][m_commands["ACT"]] = Lambdas::Power::Rank::ACT<DDR5>;
+  t[m_levels["rank"]][m_commands["PRE"]] = Lambdas::Power::Rank::PRE<DDR5>;
+  t[m_levels["rank"]][m_commands["PREA"]] = Lambdas::Power::Rank::PREA<DDR5>;
+  t[m_levels["rank"]][m_commands["REFab"]] = Lambdas::Power::Rank::REFab<DDR5>;
+  t[m_levels["rank"]][m_commands["REFab_end"]] = Lambdas::Power::Rank::REFab_end<DDR5>;
+  // t[m_levels["rank"]][m_commands["RFMab"]] = Lambdas::Power::Rank::REFab<DDR5>;
+  // t[m_levels["rank"]][m_commands["RFMab_end"]] = Lambdas::Power::Rank::REFab_end<DDR5>;
+  // t[m_levels["rank"]][m_commands["DRFMab"]] = Lambdas::Power::Rank::REFab<DDR5>;
+  // t[m_levels["rank"]][m_commands["DRFMab_end"]] = Lambdas::Power::Rank::REFab_end<DDR5>;
+
+  t[m_levels["rank"]][m_commands["PREsb"]] = Lambdas::Power::Rank::PREsb<DDR5>;
+  return t;
+}();
+
 }        // namespace Ramulator
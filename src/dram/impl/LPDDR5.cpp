@@ -196,15 +196,19 @@ class LPDDR5 : public IDRAM, public Implementation {
   public:
     struct Node : public DRAMNodeBase<LPDDR5> {
       Clk_t m_final_synced_cycle = -1; // Extra CAS Sync command needed for RD/WR after this cycle
+      Clk_t m_expired_synced_cycle = -1; // The last WCK sync expiry accounted for in the state epoch
 
       Node(LPDDR5* dram, Node* parent, int level, int id) : DRAMNodeBase<LPDDR5>(dram, parent, level, id) {};
     };
     std::vector<Node*> m_channels;
     
-    FuncMatrix<ActionFunc_t<Node>>  m_actions;
-    FuncMatrix<PreqFunc_t<Node>>    m_preqs;
-    FuncMatrix<RowhitFunc_t<Node>>  m_rowhits;
-    FuncMatrix<RowopenFunc_t<Node>> m_rowopens;
+    template<typename F>
+    using FuncTable_t = FuncTable<F, m_levels.size(), m_commands.size()>;
+    // Built at compile time below the class, so that the node recursion indexes them at a fixed address (see FuncTable)
+    static const FuncTable_t<ActionFuncPtr_t<Node>>   m_actions;
+    static const FuncTable_t<PreqFuncPtr_t<Node>>     m_preqs;
+    static const FuncTable_t<RowhitFuncPtr_t<Node>>   m_rowhits;
+    static const FuncTable_t<RowopenFuncPtr_t<Node>>  m_rowopens;
 
     State_t last_m_states[4][4];
 
@@ -240,6 +244,11 @@ class LPDDR5 : public IDRAM, public Implementation {
       }
       issuedCmd = false;  
     };
+
+    Clk_t get_next_event_clk() override {
+      // The VCD waveform is written every cycle
+      return m_clk + 1;
+    };
     
     ~LPDDR5() override {
       if(vcdLogger.file){
@@ -251,11 +260,6 @@ class LPDDR5 : public IDRAM, public Implementation {
       RAMULATOR_DECLARE_SPECS();
       set_organization();
       set_timing_vals();
-
-      set_actions();
-      set_preqs();
-      set_rowhits();
-      set_rowopens();
       
       create_nodes();
 
@@ -295,6 +299,11 @@ class LPDDR5 : public IDRAM, public Implementation {
       return m_channels[channel_id]->check_ready(command, addr_vec, m_clk);
     };
 
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      return m_channels[channel_id]->get_ready_clk(command, addr_vec);
+    };
+
     bool check_rowbuffer_hit(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
       return m_channels[channel_id]->check_rowbuffer_hit(command, addr_vec, m_clk);
@@ -305,6 +314,20 @@ class LPDDR5 : public IDRAM, public Implementation {
       return m_channels[channel_id]->check_node_open(command, addr_vec, m_clk);
     };
 
+    int64_t get_state_epoch(const AddrVec_t& addr_vec) override {
+      Node* channel = m_channels[addr_vec[m_levels["channel"]]];
+      int rank_id = addr_vec[m_levels["rank"]];
+      if (rank_id != -1) {
+        // The WCK of a rank falls out of sync with time rather than with a command, so the expiry counts as a state change
+        Node* rank = channel->m_child_nodes[rank_id];
+        if (rank->m_final_synced_cycle < m_clk && rank->m_expired_synced_cycle != rank->m_final_synced_cycle) {
+          rank->m_expired_synced_cycle = rank->m_final_synced_cycle;
+          rank->bump_state_epoch();
+        }
+      }
+      return channel->get_state_epoch(addr_vec);
+    };
+
   private:
     void set_organization() {
       // Channel width
@@ -522,124 +545,6 @@ class LPDDR5 : public IDRAM, public Implementation {
 
     };
 
-    void set_actions() {
-      m_actions.resize(m_levels.size(), std::vector<ActionFunc_t<Node>>(m_commands.size()));
-
-      // Rank Actions
-      m_actions[m_levels["rank"]][m_commands["PREA"]] = Lambdas::Action::Rank::PREab<LPDDR5>;
-      m_actions[m_levels["rank"]][m_commands["CASRD"]] = [this] (Node* node, int cmd, int target_id, Clk_t clk) {
-        node->m_final_synced_cycle = clk + m_timing_vals("nCL") + m_timing_vals("nBL16") + m_timing_vals("nWCKPST") + 1; 
-      };
-      m_actions[m_levels["rank"]][m_commands["CASWR"]] = [this] (Node* node, int cmd, int target_id, Clk_t clk) {
-        node->m_final_synced_cycle = clk + m_timing_vals("nCWL") + m_timing_vals("nBL16") + m_timing_vals("nWCKPST") + 1; 
-      };
-      m_actions[m_levels["rank"]][m_commands["RD16"]] = [this] (Node* node, int cmd, int target_id, Clk_t clk) {
-        node->m_final_synced_cycle = clk + m_timing_vals("nCL") + m_timing_vals("nBL16") + m_timing_vals("nWCKPST"); 
-      };
-      m_actions[m_levels["rank"]][m_commands["WR16"]] = [this] (Node* node, int cmd, int target_id, Clk_t clk) {
-        node->m_final_synced_cycle = clk + m_timing_vals("nCWL") + m_timing_vals("nBL16") + m_timing_vals("nWCKPST"); 
-      };
-      // Bank actions
-      m_actions[m_levels["bank"]][m_commands["ACT-1"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
-        node->m_state = m_states["Pre-Opened"];
-        node->m_row_state[target_id] = m_states["Pre-Opened"];
-      };
-      m_actions[m_levels["bank"]][m_commands["ACT-2"]] = Lambdas::Action::Bank::ACT<LPDDR5>;
-      m_actions[m_levels["bank"]][m_commands["PRE"]]   = Lambdas::Action::Bank::PRE<LPDDR5>;
-      m_actions[m_levels["bank"]][m_commands["RD16A"]] = Lambdas::Action::Bank::PRE<LPDDR5>;
-      m_actions[m_levels["bank"]][m_commands["WR16A"]] = Lambdas::Action::Bank::PRE<LPDDR5>;
-    };
-
-    void set_preqs() {
-      m_preqs.resize(m_levels.size(), std::vector<PreqFunc_t<Node>>(m_commands.size()));
-
-      // Rank Preqs
-      m_preqs[m_levels["rank"]][m_commands["REFab"]] = Lambdas::Preq::Rank::RequireAllBanksClosed<LPDDR5>;
-      m_preqs[m_levels["rank"]][m_commands["RFMab"]] = Lambdas::Preq::Rank::RequireAllBanksClosed<LPDDR5>;
-
-      m_preqs[m_levels["rank"]][m_commands["REFpb"]] = [this] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-
-        for (auto bg : node->m_child_nodes) {
-          for (auto bank : bg->m_child_nodes) {
-            int num_banks_per_bg = m_organization.count[m_levels["bank"]];
-            int flat_bankid = bank->m_node_id + bg->m_node_id * num_banks_per_bg;
-            if (flat_bankid == addr_vec[LPDDR5::m_levels["bank"]] || flat_bankid == addr_vec[LPDDR5::m_levels["bank"]] + 8) {
-              switch (node->m_state) {
-                case m_states["Pre-Opened"]: return m_commands["PRE"];
-                case m_states["Opened"]: return m_commands["PRE"];
-              }
-            }
-          }
-        }
-
-        return cmd;
-      };
-      
-      m_preqs[m_levels["rank"]][m_commands["RFMpb"]] = m_preqs[m_levels["rank"]][m_commands["REFpb"]];
-
-      // Bank Preqs
-      m_preqs[m_levels["bank"]][m_commands["RD16"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-        switch (node->m_state) {
-          case m_states["Closed"]: return m_commands["ACT-1"];
-          case m_states["Pre-Opened"]: return m_commands["ACT-2"];
-          case m_states["Opened"]: {
-            if (node->m_row_state.find(addr_vec[m_levels["row"]]) != node->m_row_state.end()) {
-              Node* rank = node->m_parent_node->m_parent_node;
-              if (rank->m_final_synced_cycle < clk) {
-                return m_commands["CASRD"];
-              } else {
-                return cmd;
-              }
-            } else {
-              return m_commands["PRE"];
-            }
-          }    
-          default: {
-            spdlog::error("[Preq::Bank] Invalid bank state for an RD/WR command!");
-            std::exit(-1);      
-          } 
-        }
-      };
-      m_preqs[m_levels["bank"]][m_commands["WR16"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-        switch (node->m_state) {
-          case m_states["Closed"]: return m_commands["ACT-1"];
-          case m_states["Pre-Opened"]: return m_commands["ACT-2"];
-          case m_states["Opened"]: {
-            if (node->m_row_state.find(addr_vec[m_levels["row"]]) != node->m_row_state.end()) {
-              Node* rank = node->m_parent_node->m_parent_node;
-              if (rank->m_final_synced_cycle < clk) {
-                return m_commands["CASWR"];
-              } else {
-                return cmd;
-              }
-            } else {
-              return m_commands["PRE"];
-            }
-          }    
-          default: {
-            spdlog::error("[Preq::Bank] Invalid bank state for an RD/WR command!");
-            std::exit(-1);      
-          } 
-        }
-      };
-    };
-
-    void set_rowhits() {
-      m_rowhits.resize(m_levels.size(), std::vector<RowhitFunc_t<Node>>(m_commands.size()));
-
-      m_rowhits[m_levels["bank"]][m_commands["RD16"]] = Lambdas::RowHit::Bank::RDWR<LPDDR5>;
-      m_rowhits[m_levels["bank"]][m_commands["WR16"]] = Lambdas::RowHit::Bank::RDWR<LPDDR5>;
-    }
-
-
-    void set_rowopens() {
-      m_rowopens.resize(m_levels.size(), std::vector<RowhitFunc_t<Node>>(m_commands.size()));
-
-      m_rowopens[m_levels["bank"]][m_commands["RD16"]] = Lambdas::RowOpen::Bank::RDWR<LPDDR5>;
-      m_rowopens[m_levels["bank"]][m_commands["WR16"]] = Lambdas::RowOpen::Bank::RDWR<LPDDR5>;
-    }
-
-
     void create_nodes() {
       int num_channels = m_organization.count[m_levels["channel"]];
       for (int i = 0; i < num_channels; i++) {
@@ -650,4 +555,123 @@ class LPDDR5 : public IDRAM, public Implementation {
 };
 
 
+/************************************************
+ *     Node Actions, Preqs, Row Hits/Opens
+ ***********************************************/
+constexpr LPDDR5::FuncTable_t<ActionFuncPtr_t<LPDDR5::Node>> LPDDR5::m_actions = [] {
+  FuncTable_t<ActionFuncPtr_t<Node>> t;
+  // Rank Actions
+  t[m_levels["rank"]][m_commands["PREA"]] = Lambdas::Action::Rank::PREab<LPDDR5>;
+  t[m_levels["rank"]][m_commands["CASRD"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_final_synced_cycle = clk + node->m_spec->m_timing_vals("nCL") + node->m_spec->m_timing_vals("nBL16") + node->m_spec->m_timing_vals("nWCKPST") + 1; 
+  };
+  t[m_levels["rank"]][m_commands["CASWR"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_final_synced_cycle = clk + node->m_spec->m_timing_vals("nCWL") + node->m_spec->m_timing_vals("nBL16") + node->m_spec->m_timing_vals("nWCKPST") + 1; 
+  };
+  t[m_levels["rank"]][m_commands["RD16"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_final_synced_cycle = clk + node->m_spec->m_timing_vals("nCL") + node->m_spec->m_timing_vals("nBL16") + node->m_spec->m_timing_vals("nWCKPST"); 
+  };
+  t[m_levels["rank"]][m_commands["WR16"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_final_synced_cycle = clk + node->m_spec->m_timing_vals("nCWL") + node->m_spec->m_timing_vals("nBL16") + node->m_spec->m_timing_vals("nWCKPST"); 
+  };
+  // Bank actions
+  t[m_levels["bank"]][m_commands["ACT-1"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_state = m_states["Pre-Opened"];
+    node->m_row_state.set(target_id, m_states["Pre-Opened"]);
+  };
+  t[m_levels["bank"]][m_commands["ACT-2"]] = Lambdas::Action::Bank::ACT<LPDDR5>;
+  t[m_levels["bank"]][m_commands["PRE"]]   = Lambdas::Action::Bank::PRE<LPDDR5>;
+  t[m_levels["bank"]][m_commands["RD16A"]] = Lambdas::Action::Bank::PRE<LPDDR5>;
+  t[m_levels["bank"]][m_commands["WR16A"]] = Lambdas::Action::Bank::PRE<LPDDR5>;
+  return t;
+}();
+
+constexpr LPDDR5::FuncTable_t<PreqFuncPtr_t<LPDDR5::Node>> LPDDR5::m_preqs = [] {
+  FuncTable_t<PreqFuncPtr_t<Node>> t;
+  // Rank Preqs
+  t[m_levels["rank"]][m_commands["REFab"]] = Lambdas::Preq::Rank::RequireAllBanksClosed<LPDDR5>;
+  t[m_levels["rank"]][m_commands["RFMab"]] = Lambdas::Preq::Rank::RequireAllBanksClosed<LPDDR5>;
+
+  t[m_levels["rank"]][m_commands["REFpb"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+
+    for (auto bg : node->m_child_nodes) {
+      for (auto bank : bg->m_child_nodes) {
+        int num_banks_per_bg = node->m_spec->m_organization.count[m_levels["bank"]];
+        int flat_bankid = bank->m_node_id + bg->m_node_id * num_banks_per_bg;
+        if (flat_bankid == addr_vec[LPDDR5::m_levels["bank"]] || flat_bankid == addr_vec[LPDDR5::m_levels["bank"]] + 8) {
+          switch (node->m_state) {
+            case m_states["Pre-Opened"]: return m_commands["PRE"];
+            case m_states["Opened"]: return m_commands["PRE"];
+          }
+        }
+      }
+    }
+
+    return cmd;
+  };
+  
+  t[m_levels["rank"]][m_commands["RFMpb"]] = t[m_levels["rank"]][m_commands["REFpb"]];
+
+  // Bank Preqs
+  t[m_levels["bank"]][m_commands["RD16"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+    switch (node->m_state) {
+      case m_states["Closed"]: return m_commands["ACT-1"];
+      case m_states["Pre-Opened"]: return m_commands["ACT-2"];
+      case m_states["Opened"]: {
+        if (node->m_row_state.contains(addr_vec[m_levels["row"]])) {
+          Node* rank = node->m_parent_node->m_parent_node;
+          if (rank->m_final_synced_cycle < clk) {
+            return m_commands["CASRD"];
+          } else {
+            return cmd;
+          }
+        } else {
+          return m_commands["PRE"];
+        }
+      }    
+      default: {
+        spdlog::error("[Preq::Bank] Invalid bank state for an RD/WR command!");
+        std::exit(-1);      
+      } 
+    }
+  };
+  t[m_levels["bank"]][m_commands["WR16"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+    switch (node->m_state) {
+      case m_states["Closed"]: return m_commands["ACT-1"];
+      case m_states["Pre-Opened"]: return m_commands["ACT-2"];
+      case m_states["Opened"]: {
+        if (node->m_row_state.contains(addr_vec[m_levels["row"]])) {
+          Node* rank = node->m_parent_node->m_parent_node;
+          if (rank->m_final_synced_cycle < clk) {
+            return m_commands["CASWR"];
+          } else {
+            return cmd;
+          }
+        } else {
+          return m_commands["PRE"];
+        }
+      }    
+      default: {
+        spdlog::error("[Preq::Bank] Invalid bank state for an RD/WR command!");
+        std::exit(-1);      
+      } 
+    }
+  };
+  return t;
+}();
+
+constexpr LPDDR5::FuncTable_t<RowhitFuncPtr_t<LPDDR5::Node>> LPDDR5::m_rowhits = [] {
+  FuncTable_t<RowhitFuncPtr_t<Node>> t;
+  t[m_levels["bank"]][m_commands["RD16"]] = Lambdas::RowHit::Bank::RDWR<LPDDR5>;
+  t[m_levels["bank"]][m_commands["WR16"]] = Lambdas::RowHit::Bank::RDWR<LPDDR5>;
+  return t;
+}();
+
+constexpr LPDDR5::FuncTable_t<RowopenFuncPtr_t<LPDDR5::Node>> LPDDR5::m_rowopens = [] {
+  FuncTable_t<RowopenFuncPtr_t<Node>> t;
+  t[m_levels["bank"]][m_commands["RD16"]] = Lambdas::RowOpen::Bank::RDWR<LPDDR5>;
+  t[m_levels["bank"]][m_commands["WR16"]] = Lambdas::RowOpen::Bank::RDWR<LPDDR5>;
+  return t;
+}();
+
 }        // namespace Ramulator
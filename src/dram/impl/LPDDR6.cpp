@@ -1,9 +1,9 @@
+#include <bit>
+#include <optional>
+
 #include "dram/dram.h"
 #include "dram/lambdas.h"
-#include <bitset>
-
-// TODO: RD24A/WR24A的timing和行为还没有实现
-// TODO: refresh相关的timing没有实现，目前只有全片refresh的功能
+#include "dram/vcd_tracer.h"
 
 
 namespace Ramulator {
@@ -24,9 +24,21 @@ class LPDDR6 : public IDRAM, public Implementation {
 
     // nCCD_L: BL/n_max, nCCD_S: BL/n_min
     // 去除nRC，因为nRC=nRAS+nRPab或nPRpb
+    // Only the LPDDR6_6400 speed bin is modeled. Other rates need every rate-dependent timing in the config.
     inline static const std::map<std::string, std::vector<int>> timing_presets = {
-      //   name         rate   nBL  nCL  nWCKPST   nRCD_r   nRCD_w   nRPab  nRPpb   nRAS   nWTP  nRTP nCWL nCCD_S nCCD_L nRRD nWTR_S nWTR_L nFAW  nPPD  nREFI nCS,  tCK_ps
-      {"LPDDR6_6400",  {6400,  6,   34,     1,      29,      13,     69,    64,     32,    20,   8,  18,    6,     12,    6,    10,    20,   24,   4,    -1,   2,   1250}},
+      //   name             rate   nBL  nCL  nWCKPST  nWCKSYNC  nRCD_r   nRCD_w   nRPab  nRPpb   nRAS   nWTP  nRTP nCWL nCCD_S nCCD_L nRRD nWTR_S nWTR_L nFAW  nPPD  nREFI nRFCab nRFCpb nPBR2PBR nPBR2ACT nCS  nCKE  nXP  nSR  nXSR  tCK_ps
+      {"LPDDR6_6400",      {6400,  6,   34,     1,      -1,      29,      13,     69,    64,     32,    20,   8,  18,    6,     12,    6,    10,    20,   24,   4,    -1,   -1,     -1,    -1,      -1,      2,   -1,   -1,  -1,  -1,   1250}},
+    };
+
+    inline static const std::map<std::string, std::vector<double>> voltage_presets = {
+      //   name          VDD1     VDD2
+      {"Default",       {1.8,     1.05}},
+    };
+
+    // Per-rail currents in mA (_1: VDD1, _2: VDD2)
+    inline static const std::map<std::string, std::vector<double>> current_presets = {
+      // name           IDD0_1 IDD0_2 IDD2N_1 IDD2N_2 IDD3N_1 IDD3N_2 IDD4R_1 IDD4R_2 IDD4W_1 IDD4W_2 IDD5AB_1 IDD5AB_2 IDD5PB_1 IDD5PB_2 IDD2P_1 IDD2P_2 IDD6_1 IDD6_2 IWCK_1 IWCK_2
+      {"Default",       {6,     55,    1.5,    18,     2,      28,     3,      240,    3,      210,    10,       60,       3,        35,       0.6,    2.5,    0.4,   1.2,   0,     12}},
     };
 
 
@@ -34,6 +46,9 @@ class LPDDR6 : public IDRAM, public Implementation {
    *                Organization
    ***********************************************/   
     const int m_internal_prefetch_size = 24;
+    // A BL24 burst of a x12 channel is 288 bits: 256 data bits and 32 non-data bits (metadata and link ECC)
+    static constexpr int X12_BURST_BITS = 288;
+    static constexpr int X12_NON_DATA_BITS = 32;
 
     inline static constexpr ImplDef m_levels = {
       "channel", "rank", "bankgroup", "bank", "row", "column",    
@@ -50,6 +65,10 @@ class LPDDR6 : public IDRAM, public Implementation {
       "RD24",   "WR24",   "RD24A",   "WR24A",
       "REFab",  "REFpb",
       "RFMab",  "RFMpb",
+      "PDE",    "PDX",
+      "SRE",    "SRX",
+      "REFab_end", "REFpb_end",
+      "CASRD",  "CASWR",   // WCK2CK Sync
     };
 
     inline static const ImplLUT m_command_scopes = LUT (
@@ -58,8 +77,12 @@ class LPDDR6 : public IDRAM, public Implementation {
         {"ACT-1", "row"},    {"ACT-2",  "row"},
         {"PRE",   "bank"},   {"PREA",   "rank"},
         {"RD24",  "column"}, {"WR24",   "column"}, {"RD24A", "column"}, {"WR24A", "column"},
-        {"REFab", "rank"},   {"REFpb",  "rank"},
-        {"RFMab", "rank"},   {"RFMpb",  "rank"},
+        {"REFab", "rank"},   {"REFpb",  "bank"},
+        {"RFMab", "rank"},   {"RFMpb",  "bank"},
+        {"PDE",   "rank"},   {"PDX",    "rank"},
+        {"SRE",   "rank"},   {"SRX",    "rank"},
+        {"REFab_end", "rank"}, {"REFpb_end", "bank"},
+        {"CASRD", "bank"},   {"CASWR",  "bank"},
       }
     );
 
@@ -75,6 +98,10 @@ class LPDDR6 : public IDRAM, public Implementation {
         {"RD24",  "2CK"}, {"WR24",   "2CK"}, {"RD24A", "2CK"}, {"WR24A", "2CK"},
         {"REFab", "2CK"},   {"REFpb",  "2CK"},
         {"RFMab", "2CK"},   {"RFMpb",  "2CK"},
+        {"PDE",   "2CK"},   {"PDX",    "2CK"},
+        {"SRE",   "2CK"},   {"SRX",    "2CK"},
+        {"REFab_end", "2CK"}, {"REFpb_end", "2CK"},
+        {"CASRD", "2CK"},   {"CASWR",  "2CK"},
       }
     );
 
@@ -94,17 +121,28 @@ class LPDDR6 : public IDRAM, public Implementation {
         {"REFpb",  {false,  false,   false,   true }},
         {"RFMab",  {false,  false,   false,   true }},
         {"RFMpb",  {false,  false,   false,   true }},
+        {"PDE",    {false,  false,   false,   false}},
+        {"PDX",    {false,  false,   false,   false}},
+        {"SRE",    {false,  false,   false,   false}},
+        {"SRX",    {false,  false,   false,   false}},
+        {"REFab_end", {false,  true,  false,   false}},
+        {"REFpb_end", {false,  true,  false,   false}},
+        {"CASRD",  {false,  false,   false,   false}},
+        {"CASWR",  {false,  false,   false,   false}},
       }
     );
 
     inline static constexpr ImplDef m_requests = {
-      "read", "write", "all-bank-refresh", "open-row", "close-row"
+      "read", "write", "all-bank-refresh", "per-bank-refresh", "open-row", "close-row", "power-down", "self-refresh",
+      "read-autoprecharge", "write-autoprecharge"
     };
 
     inline static const ImplLUT m_request_translations = LUT (
       m_requests, m_commands, {
         {"read", "RD24"}, {"write", "WR24"}, 
-        {"all-bank-refresh", "REFab"}, {"open-row", "ACT-1"}, {"close-row", "PRE"}
+        {"all-bank-refresh", "REFab"}, {"per-bank-refresh", "REFpb"}, {"open-row", "ACT-1"}, {"close-row", "PRE"},
+        {"power-down", "PDE"}, {"self-refresh", "SRE"},
+        {"read-autoprecharge", "RD24A"}, {"write-autoprecharge", "WR24A"}
       }
     );
 
@@ -115,7 +153,7 @@ class LPDDR6 : public IDRAM, public Implementation {
     // nWCKPST=RD(tWCKPST/tCK), 时序约束必须考虑-nCK!!!
     inline static constexpr ImplDef m_timings = {
       "rate", 
-      "nBL24", "nCL", "nWCKPST", "nRCD_r", "nRCD_w", 
+      "nBL24", "nCL", "nWCKPST", "nWCKSYNC", "nRCD_r", "nRCD_w", 
       "nRPab", "nRPpb", "nRAS", "nWTP", "nRTP", "nCWL",
       "nCCD_S", "nCCD_L",
       "nRRD",
@@ -123,17 +161,44 @@ class LPDDR6 : public IDRAM, public Implementation {
       "nFAW",
       "nPPD",
       "nREFI",
+      "nRFCab", "nRFCpb", "nPBR2PBR", "nPBR2ACT",
       "nCS",
+      "nCKE", "nXP", "nSR", "nXSR",
       "tCK_ps"
     };
 
 
+  /************************************************
+   *                   Power
+   ***********************************************/
+    inline static constexpr ImplDef m_voltages = {
+      "VDD1", "VDD2"
+    };
+
+    inline static constexpr ImplDef m_currents = {
+      "IDD0_1",  "IDD0_2",
+      "IDD2N_1", "IDD2N_2",
+      "IDD3N_1", "IDD3N_2",
+      "IDD4R_1", "IDD4R_2",
+      "IDD4W_1", "IDD4W_2",
+      "IDD5AB_1", "IDD5AB_2",
+      "IDD5PB_1", "IDD5PB_2",
+      "IDD2P_1", "IDD2P_2",
+      "IDD6_1",  "IDD6_2",
+      "IWCK_1",  "IWCK_2",
+    };
+
+    inline static constexpr ImplDef m_cmds_counted = {
+      "ACT", "PRE", "RD", "WR", "REFab", "REFpb"
+    };
+
+
   /************************************************
    *                 Node States
    ***********************************************/
     inline static constexpr ImplDef m_states = {
     //    ACT-1       ACT-2
-       "Pre-Opened", "Opened", "Closed", "PowerUp", "N/A", "Refreshing"
+       "Pre-Opened", "Opened", "Closed", "PowerUp", "N/A", "Refreshing", "Power-Down", "Self-Refresh"
     };
 
     inline static const ImplLUT m_init_states = LUT (
@@ -148,192 +213,337 @@ class LPDDR6 : public IDRAM, public Implementation {
     );
   
   private:
-    // log
-    struct{
-      FILE* file = nullptr;
-    } vcdLogger;
+    // VCD waveform tracing (disabled unless enabled in the "vcd" param group)
+    VCDTracer m_vcd;
+    int m_vcd_cycle = -1;
+    int m_vcd_cmd = -1;
+    int m_vcd_addr = -1;
+    int m_vcd_wck_sync = -1;
+    std::vector<int> m_vcd_bank_status;         // Signal ids of the bank states of channel 0 rank 0
+    std::vector<State_t> m_vcd_bank_states;     // Last traced bank states of channel 0 rank 0
+    int m_vcd_wck_sync_state = -1;              // Last traced WCK sync state
+    bool m_vcd_cmd_bus_idle = false;            // Whether a NOP is traced for the idle command bus of channel 0
+
+    // Data bus accounting of each channel
+    struct BusStats {
+      size_t num_bursts = 0;
+      size_t payload_bytes = 0;               // Data and metadata
+      size_t raw_bytes = 0;                   // Everything on the bus, including link ECC
+      double payload_bus_utilization = 0;
+      double raw_bus_utilization = 0;
+      double payload_bandwidth = 0;           // In GB/s
+    };
+    std::vector<BusStats> m_bus_stats;
+    int m_metadata_bits = 0;                    // Non-data bits of every burst that carry host metadata (the rest carry link ECC)
+    bool m_wck_always_on = true;                // Whether WCK keeps toggling, or is only synced on demand by a CAS command
+    bool m_is_bg_mode = true;                   // Whether the banks are organized in bank groups (BG mode) or not (16B mode)
 
   public:
-    void initVCDLogger(){
-      FILE *tmpfs;
-      // 写入cmd对照表
-      tmpfs = fopen("trace/cmd_trans.txt", "w");
-      for(int i = 0; i < m_commands.size(); ++i){
-        fprintf(tmpfs, "%s %s\n", std::bitset<7>(i).to_string().c_str(), m_commands(i).data());
-      }
-      fprintf(tmpfs, "%s NOP\n", std::bitset<7>(m_commands.size()).to_string().c_str());
-      fclose(tmpfs);
-
-      // 写入bank状态对照表
-      tmpfs = fopen("trace/bank_status_trans.txt", "w");
-      for(int i = 0; i < m_states.size(); ++i){
-        fprintf(tmpfs, "%s %s\n", std::bitset<4>(i).to_string().c_str(), m_states(i).data());
-      }
-      fclose(tmpfs);
-
-      vcdLogger.file = fopen("trace/trace.vcd", "w");
-
-      fprintf(vcdLogger.file, "$timescale 1ps $end\n");
-      {
-        fprintf(vcdLogger.file, "$scope module ramulator $end\n");
-        {
-          fprintf(vcdLogger.file, "$scope module cmd $end\n");
-          fprintf(vcdLogger.file, "$var wire 64 cycle cycle $end\n"); // 当前周期
-          fprintf(vcdLogger.file, "$var wire 7 cmd cmd $end\n"); // 当前命令
-          fprintf(vcdLogger.file, "$var wire 64 addr addr $end\n"); // 当前命令对应的地址
-          fprintf(vcdLogger.file, "$var wire 2 WCKSync WCKSync $end\n"); // WCK同步状态
-          fprintf(vcdLogger.file, "$upscope $end\n");
-        }
-
-        // bank状态相关
-        {
-          fprintf(vcdLogger.file, "$scope module bank_status $end\n");
-          for (int i = 0; i < 4; i++) {
-            fprintf(vcdLogger.file, "$scope module bg%02d $end\n", i);
-            for(int j = 0; j < 4; j++) {
-              fprintf(vcdLogger.file, "$scope module ba%02d $end\n", j);
-              fprintf(vcdLogger.file, "$var wire 4 bank_status_%02d_%02d bank_status_%02d_%02d $end\n", i, j, i, j); // bank状态
-              fprintf(vcdLogger.file, "$upscope $end\n");
-            }
-            fprintf(vcdLogger.file, "$upscope $end\n");
-          }
-          fprintf(vcdLogger.file, "$upscope $end\n");
+    void set_vcd_tracer() {
+      if (!m_config["vcd"] || !param_group("vcd").param<bool>("enable").desc("Whether to dump a VCD waveform.").default_val(false)) {
+        return;
+      }
+
+      VCDTracer::Config config;
+      config.path = param_group("vcd").param<std::string>("path").desc("Output directory of the VCD waveform.").default_val("trace");
+      config.start_clk = param_group("vcd").param<Clk_t>("start_cycle").desc("First cycle to trace.").default_val(0);
+      config.end_clk = param_group("vcd").param<Clk_t>("end_cycle").desc("Last cycle to trace (-1 for no limit).").default_val(-1);
+      config.signals = param_group("vcd").param<std::vector<std::string>>("signals")
+                       .desc("Signal groups to trace (cycle, cmd, addr, WCKSync, bank_status). Traces all if not given.")
+                       .default_val(std::vector<std::string>{});
+      config.buffer_size = param_group("vcd").param<size_t>("buffer_size").desc("Number of records buffered in memory.").default_val(1 << 16);
+      m_vcd.configure(config, m_timing_vals("tCK_ps"));
+
+      m_vcd_cycle = m_vcd.add_signal("cycle", "ramulator.cmd", "cycle", 64);
+      m_vcd_cmd = m_vcd.add_signal("cmd", "ramulator.cmd", "cmd", 7);
+      m_vcd_addr = m_vcd.add_signal("addr", "ramulator.cmd", "addr", 64);
+      m_vcd_wck_sync = m_vcd.add_signal("WCKSync", "ramulator.cmd", "WCKSync", 2);
+
+      int num_bankgroups = m_organization.count[m_levels["bankgroup"]];
+      int num_banks = m_organization.count[m_levels["bank"]];
+      for (int bg = 0; bg < num_bankgroups; bg++) {
+        for (int b = 0; b < num_banks; b++) {
+          m_vcd_bank_status.push_back(m_vcd.add_signal(
+            "bank_status",
+            fmt::format("ramulator.bank_status.bg{:02d}.ba{:02d}", bg, b),
+            fmt::format("bank_status_{:02d}_{:02d}", bg, b),
+            4
+          ));
+          m_vcd_bank_states.push_back(-1);
         }
-        fprintf(vcdLogger.file, "$upscope $end\n");
       }
 
-      fprintf(vcdLogger.file, "$enddefinitions $end\n");
+      m_vcd.write_translation_table("cmd_trans.txt", std::vector<std::string_view>(m_commands.begin(), m_commands.end()), 7);
+      m_vcd.write_translation_table("bank_status_trans.txt", std::vector<std::string_view>(m_states.begin(), m_states.end()), 4);
+      m_vcd.start();
+    }
+
+    void trace_cycle() {
+      if (!m_vcd.is_in_window(m_clk)) {
+        return;
+      }
+
+      m_vcd.record(m_clk, m_vcd_cycle, m_clk);
+
+      if (!m_vcd_cmd_bus_idle && m_clk >= m_channels[0]->m_cmd_bus_ready_clk) {
+        m_vcd.record(m_clk, m_vcd_cmd, m_commands["NOP"]);
+        m_vcd_cmd_bus_idle = true;
+      }
+
+      int wck_sync_state = (m_wck_always_on || m_clk <= m_channels[0]->m_child_nodes[0]->m_final_synced_cycle) ? 0b11 : 0b00;
+      if (wck_sync_state != m_vcd_wck_sync_state) {
+        m_vcd.record(m_clk, m_vcd_wck_sync, wck_sync_state);
+        m_vcd_wck_sync_state = wck_sync_state;
+      }
 
-      fprintf(vcdLogger.file, "#0\n");
+      // Rank 0 banks come first in the flat bank states of channel 0
+      const auto& bank_states = m_channels[0]->m_store->m_states[m_levels["bank"]];
+      int num_banks = m_organization.count[m_levels["bank"]];
+      for (int flat_bank_id = 0; flat_bank_id < m_vcd_bank_states.size(); flat_bank_id++) {
+        State_t state = bank_states[flat_bank_id];
+        State_t last_state = m_vcd_bank_states[flat_bank_id];
+        if (state != last_state) {
+          if (last_state != -1) {
+            m_logger->info("At clk {}, BankGroup {} Bank {} : {} -> {}", m_clk, flat_bank_id / num_banks, flat_bank_id % num_banks, m_states(last_state), m_states(state));
+          }
+          m_vcd_bank_states[flat_bank_id] = state;
+          m_vcd.record(m_clk, m_vcd_bank_status[flat_bank_id], state);
+        }
+      }
     }
 
-    void VCDLogCycle(){
-      fprintf(vcdLogger.file, "#%lu\n", m_clk * 1250);
+    void trace_command(int command, const AddrVec_t& addr_vec) {
+      m_vcd.record(m_clk, m_vcd_cmd, command);
+      m_vcd_cmd_bus_idle = false;
+
+      uint64_t addr = 0;
+      for (int level = 0; level < m_levels.size(); level++) {
+        addr = addr * m_organization.count[level] + std::max(addr_vec[level], 0);
+      }
+      m_vcd.record(m_clk, m_vcd_addr, addr);
     }
 
 
   public:
+    // Each channel node is a sub-channel with its own command/address pins and data bus
     struct Node : public DRAMNodeBase<LPDDR6> {
       Node(LPDDR6* dram, Node* parent, int level, int id) : DRAMNodeBase<LPDDR6>(dram, parent, level, id) {};
+
+      // Channel: the command being issued on the sub-channel's command bus
+      Clk_t m_cmd_bus_ready_clk = 0;    // The command bus is reserved by the current command until this cycle
+      Clk_t m_cur_cmd_countdown = 0;    // Countdown for the current command's duration
+      int m_cur_cmd = 0; // 记录当前正在执行的指令，在最后一个周期实际生效
+      AddrVec_t m_cur_addr_vec; // 当前正在执行的指令对应的地址向量 
+
+      // Rank
+      Clk_t m_final_synced_cycle = -1; // Extra CAS Sync command needed for RD/WR after this cycle
+      Clk_t m_expired_synced_cycle = -1; // The last WCK sync expiry accounted for in the state epoch
     };
     std::vector<Node*> m_channels;
     
-    FuncMatrix<ActionFunc_t<Node>>  m_actions;
-    FuncMatrix<PreqFunc_t<Node>>    m_preqs;
-    FuncMatrix<RowhitFunc_t<Node>>  m_rowhits;
-    FuncMatrix<RowopenFunc_t<Node>> m_rowopens;
-
-    State_t last_m_states[4][4];
-  
-  // 相关状态定义
-  public:
-    Clk_t m_final_synced_cycle = -1; // Extra CAS Sync command needed for RD/WR after this cycle
-
-    Clk_t m_cur_cmd_countdown = 0;    // Countdown for the current command's duration
-    int m_cur_cmd = 0; // 记录当前正在执行的指令，在最后一个周期实际生效
-    AddrVec_t m_cur_addr_vec; // 当前正在执行的指令对应的地址向量 
-
+    template<typename F>
+    using FuncTable_t = FuncTable<F, m_levels.size(), m_commands.size()>;
+    // Built at compile time below the class, so that the node recursion indexes them at a fixed address (see FuncTable)
+    static const FuncTable_t<ActionFuncPtr_t<Node>>   m_actions;
+    static const FuncTable_t<PreqFuncPtr_t<Node>>     m_preqs;
+    static const FuncTable_t<RowhitFuncPtr_t<Node>>   m_rowhits;
+    static const FuncTable_t<RowopenFuncPtr_t<Node>>  m_rowopens;
 
   public:
     void tick() override {
       m_clk++;
 
-      // log 当前周期
-      VCDLogCycle();
-      fprintf(vcdLogger.file, "b%s cycle\n", std::bitset<64>(m_clk).to_string().c_str());
-      // log WCKSync状态
-      if(m_clk <= m_final_synced_cycle){
-        fprintf(vcdLogger.file, "b11 WCKSync\n");
-      } else {
-        fprintf(vcdLogger.file, "b00 WCKSync\n");
+      if (m_vcd.is_enabled()) {
+        trace_cycle();
       }
 
-      for(int bg = 0; bg < 4; ++bg){
-        for(int b = 0; b < 4; ++b){
-          auto curState = m_channels[0]->m_child_nodes[0]->m_child_nodes[bg]->m_child_nodes[b]->m_state;
-          auto lastState = last_m_states[bg][b];
-          if(curState != lastState){
-            m_logger->info("At clk {}, BankGroup {} Bank {} : {} -> {}", m_clk, bg, b, m_states(lastState), m_states(curState));
-            last_m_states[bg][b] = curState;
-            fprintf(vcdLogger.file, "b%s bank_status_%02d_%02d\n", std::bitset<4>(curState).to_string().c_str(), bg, b);
-          }
+      // Check if there is any future action (e.g., the end of a refresh) at this cycle
+      for (int i = m_future_actions.size() - 1; i >= 0; i--) {
+        auto& future_action = m_future_actions[i];
+        if (future_action.clk == m_clk) {
+          handle_future_action(future_action.cmd, future_action.addr_vec);
+          m_future_actions.erase(m_future_actions.begin() + i);
         }
-      } 
+      }
 
       // 处理当前命令
-      handle_cur_command();
-    };
-    
-    ~LPDDR6() override {
-      if(vcdLogger.file){
-        fclose(vcdLogger.file);
+      for (auto channel : m_channels) {
+        handle_cur_command(channel);
+      }
+
+      if (!m_wck_always_on) {
+        expire_wck_sync();
       }
     };
 
     void init() override {
       RAMULATOR_DECLARE_SPECS();
       set_organization();
+      set_metadata();
+      set_wck_mode();
       set_timing_vals();
 
-      set_actions();
-      set_preqs();
-      set_rowhits();
-      set_rowopens();
+      set_powers();
       
       create_nodes();
 
       m_logger = Logging::create_logger("LPDDR6");
-      initVCDLogger();
+      set_vcd_tracer();
+      set_bus_stats();
+    };
+
+    void finalize() override {
+      m_vcd.close();
 
-      m_cur_cmd = m_commands["NOP"];
-      m_cur_cmd_countdown = 1;
-      m_cur_addr_vec = AddrVec_t(m_levels.size(), 0);
+      for (auto& bus_stats : m_bus_stats) {
+        process_bus_stats(bus_stats);
+      }
+
+      if (m_drampower_enable) {
+        for (auto& rank_stats : m_power_stats) {
+          process_rank_energy(rank_stats);
+        }
+      }
+    };
+
+    Clk_t get_next_event_clk() override {
+      if (m_vcd.is_enabled()) {
+        return m_clk + 1;
+      }
+      for (auto channel : m_channels) {
+        if (channel->m_cur_cmd_countdown > 0) {
+          return m_clk + 1;
+        }
+      }
+      return IDRAM::get_next_event_clk();
     };
 
     // issue_command作为接口接收命令，launch_command执行实际的命令逻辑
     void issue_command(int command, const AddrVec_t& addr_vec) override {
-      m_cur_cmd = command;
-      m_cur_addr_vec = addr_vec;
+      Node* channel = m_channels[addr_vec[m_levels["channel"]]];
+      // The command takes effect in its last cycle on the command bus, which it reserves until then
+      int nCK = m_command_nCK[command] == m_nCK["1CK"] ? 1 : 2;
+      channel->m_cmd_bus_ready_clk = m_clk + nCK;
+
+      // Only the commands of channel 0 are traced, like its bank states
+      if (m_vcd.is_enabled() && channel->m_node_id == 0) {
+        trace_command(command, addr_vec);
+      }
+
       // 在dram_controller中先step dram，再step controller，所以当前clk周期已经到了
-      m_cur_cmd_countdown = (m_command_nCK[command] == m_nCK["1CK"]) ? 0 : 
-                            (m_command_nCK[command] == m_nCK["2CK"]) ? 1 : 
-                            1;
-      
-      // VCD log 当前命令
-      fprintf(vcdLogger.file, "b%s cmd\n", std::bitset<7>(m_cur_cmd).to_string().c_str());
-      unsigned long long addr = 0;
-      addr = m_cur_addr_vec[m_levels["channel"]];
-      addr = (addr * m_organization.count[m_levels["rank"]]) + m_cur_addr_vec[m_levels["rank"]];
-      addr = (addr * m_organization.count[m_levels["bankgroup"]]) + m_cur_addr_vec[m_levels["bankgroup"]];
-      addr = (addr * m_organization.count[m_levels["bank"]]) + m_cur_addr_vec[m_levels["bank"]];
-      addr = (addr * m_organization.count[m_levels["row"]]) + m_cur_addr_vec[m_levels["row"]];
-      addr = (addr * m_organization.count[m_levels["column"]]) + m_cur_addr_vec[m_levels["column"]];
-      fprintf(vcdLogger.file, "b%s addr\n", std::bitset<64>(addr).to_string().c_str());
-    };
-
-    void handle_cur_command(){
-      if(m_cur_cmd_countdown > 0){
-        if(m_cur_cmd_countdown == 1){
-          launch_command(m_cur_cmd, m_cur_addr_vec);
-        }
-        m_cur_cmd_countdown--;
-        // VCD log 当前命令
-        fprintf(vcdLogger.file, "b%s cmd\n", std::bitset<7>(m_cur_cmd).to_string().c_str());
-        unsigned long long addr = 0;
-        addr = m_cur_addr_vec[m_levels["channel"]];
-        addr = (addr * m_organization.count[m_levels["rank"]]) + m_cur_addr_vec[m_levels["rank"]];
-        addr = (addr * m_organization.count[m_levels["bankgroup"]]) + m_cur_addr_vec[m_levels["bankgroup"]];
-        addr = (addr * m_organization.count[m_levels["bank"]]) + m_cur_addr_vec[m_levels["bank"]];
-        addr = (addr * m_organization.count[m_levels["row"]]) + m_cur_addr_vec[m_levels["row"]];
-        addr = (addr * m_organization.count[m_levels["column"]]) + m_cur_addr_vec[m_levels["column"]];
-        fprintf(vcdLogger.file, "b%s addr\n", std::bitset<64>(addr).to_string().c_str());
+      if (nCK == 1) {
+        launch_command(command, addr_vec);
+        return;
+      }
+      channel->m_cur_cmd = command;
+      channel->m_cur_addr_vec = addr_vec;
+      channel->m_cur_cmd_countdown = nCK - 1;
+    };
+
+    void handle_cur_command(Node* channel){
+      if(channel->m_cur_cmd_countdown > 0){
+        if(channel->m_cur_cmd_countdown == 1){
+          launch_command(channel->m_cur_cmd, channel->m_cur_addr_vec);
+        }
+        channel->m_cur_cmd_countdown--;
       }
     }
 
     void launch_command(int command, const AddrVec_t& addr_vec) {
       int channel_id = addr_vec[m_levels["channel"]];
+      if (m_command_meta[command].is_accessing) {
+        m_bus_stats[channel_id].num_bursts++;
+      }
       m_channels[channel_id]->update_timing(command, addr_vec, m_clk);
+      if (is_per_bank_refresh(command)) {
+        m_channels[channel_id]->update_timing(command, get_refresh_partner_addr(addr_vec), m_clk);
+      }
+      if (m_drampower_enable) {
+        update_power(command, addr_vec);
+      }
       m_channels[channel_id]->update_states(command, addr_vec, m_clk);
+      if (is_per_bank_refresh(command)) {
+        m_channels[channel_id]->update_states(command, get_refresh_partner_addr(addr_vec), m_clk);
+      }
+      if (!m_wck_always_on && is_wck_command(command)) {
+        update_wck_sync(command, addr_vec);
+        if (m_drampower_enable) {
+          update_wck_power(addr_vec);
+        }
+      }
+
+      // Check if the command requires future action
+      check_future_action(command, addr_vec);
+    };
+
+    /**
+     * @brief    Extends the synced WCK window of an on-demand WCK to the end of the burst of a RD/WR or CAS command.
+     * @details  Only an on-demand WCK tracks when its sync ends, so this depends on the config and is not a node action.
+     */
+    void update_wck_sync(int command, const AddrVec_t& addr_vec) {
+      Node* rank = m_channels[addr_vec[m_levels["channel"]]]->m_child_nodes[addr_vec[m_levels["rank"]]];
+      bool is_read = command == m_commands["RD24"] || command == m_commands["RD24A"] || command == m_commands["CASRD"];
+      Clk_t latency = is_read ? m_timing_vals("nCL") : m_timing_vals("nCWL");
+      if (command == m_commands["CASRD"] || command == m_commands["CASWR"]) {
+        // A CAS with WCK sync starts the WCK, which stays synced until the end of the burst that follows it
+        latency += m_timing_vals("nWCKSYNC");
+      }
+      rank->m_final_synced_cycle = m_clk + latency + m_timing_vals("nBL24") + m_timing_vals("nWCKPST");
+      rank->bump_state_epoch();
+    };
+
+    /**
+     * @brief    Records the end of the synced WCK window of every rank whose window has just ended.
+     * @details
+     * The WCK falls out of sync with time rather than with a command, so the expiry counts as a state change
+     * of the rank (a RD/WR now needs a CAS first). The controller only skips cycles with empty queues, so no
+     * cached prerequisite can miss an expiry that falls into skipped cycles.
+     */
+    void expire_wck_sync() {
+      for (auto channel : m_channels) {
+        for (auto rank : channel->m_child_nodes) {
+          if (rank->m_final_synced_cycle < m_clk && rank->m_expired_synced_cycle != rank->m_final_synced_cycle) {
+            rank->m_expired_synced_cycle = rank->m_final_synced_cycle;
+            rank->bump_state_epoch();
+          }
+        }
+      }
+    };
+
+    /**
+     * @brief    Schedules the end of a refresh.
+     * @details
+     * The refreshed banks return to Closed at the first cycle the timing constraints allow an ACT-1 to them
+     * (i.e., tRFC after the refresh minus the ACT-1 to ACT-2 distance), so that the ACT-1 finds them closed.
+     */
+    void check_future_action(int command, const AddrVec_t& addr_vec) {
+      switch (command) {
+        case m_commands["REFab"]: case m_commands["RFMab"]:
+          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nRFCab") - 2 - 1});
+          break;
+        case m_commands["REFpb"]: case m_commands["RFMpb"]:
+          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nRFCpb") - 2 - 1});
+          break;
+        default:
+          // Other commands do not require future actions
+          break;
+      }
+    };
+
+    void handle_future_action(int command, const AddrVec_t& addr_vec) {
+      int channel_id = addr_vec[m_levels["channel"]];
+      switch (command) {
+        case m_commands["REFab"]: case m_commands["RFMab"]:
+          m_channels[channel_id]->update_states(m_commands["REFab_end"], addr_vec, m_clk);
+          break;
+        case m_commands["REFpb"]: case m_commands["RFMpb"]:
+          m_channels[channel_id]->update_states(m_commands["REFpb_end"], addr_vec, m_clk);
+          m_channels[channel_id]->update_states(m_commands["REFpb_end"], get_refresh_partner_addr(addr_vec), m_clk);
+          break;
+        default:
+          // Other commands do not require future actions
+          break;
+      }
     };
 
     int get_preq_command(int command, const AddrVec_t& addr_vec) override {
@@ -342,18 +552,19 @@ class LPDDR6 : public IDRAM, public Implementation {
     };
 
     bool check_ready(int command, const AddrVec_t& addr_vec) override {
-      // LPDDR6只允许在even cycle发命令
-      if(m_clk % 2 != 0){
+      if (m_clk < m_channels[addr_vec[m_levels["channel"]]]->m_cmd_bus_ready_clk) {
         return false;
       }
+      return m_clk >= get_timing_ready_clk(command, addr_vec);
+    };
 
-      // 由于even cycle的限制，理论上不会进入这个分支
-      if(m_cur_cmd_countdown > 0){
-        return false;
-      }
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) override {
+      Clk_t bus_ready_clk = m_channels[addr_vec[m_levels["channel"]]]->m_cmd_bus_ready_clk;
+      return std::max({get_timing_ready_clk(command, addr_vec), bus_ready_clk, m_clk});
+    };
 
-      int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_ready(command, addr_vec, m_clk);
+    Clk_t get_command_bus_ready_clk(int channel_id) override {
+      return m_channels[channel_id]->m_cmd_bus_ready_clk;
     };
 
     bool check_rowbuffer_hit(int command, const AddrVec_t& addr_vec) override {
@@ -366,6 +577,32 @@ class LPDDR6 : public IDRAM, public Implementation {
       return m_channels[channel_id]->check_node_open(command, addr_vec, m_clk);
     };
 
+    bool check_self_refresh(const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      Node* rank = m_channels[channel_id]->m_child_nodes[addr_vec[m_levels["rank"]]];
+      return rank->m_state == m_states["Self-Refresh"];
+    };
+
+    AddrVec_t get_preq_addr_vec(int command, int preq_command, const AddrVec_t& addr_vec) override {
+      // Once the addressed bank of a per-bank refresh is closed, its PRE closes the partner bank
+      if (is_per_bank_refresh(command) && preq_command == m_commands["PRE"] && !check_node_open(m_commands["RD24"], addr_vec)) {
+        return get_refresh_partner_addr(addr_vec);
+      }
+      return addr_vec;
+    };
+
+    int64_t get_state_epoch(const AddrVec_t& addr_vec) override {
+      Node* channel = m_channels[addr_vec[m_levels["channel"]]];
+      int rank_id = addr_vec[m_levels["rank"]];
+      int64_t epoch = channel->get_state_epoch(addr_vec);
+      if (rank_id != -1 && addr_vec[m_levels["bankgroup"]] != -1 && addr_vec[m_levels["bank"]] != -1) {
+        // A per-bank refresh also depends on the partner bank it refreshes along with the addressed one
+        auto [partner_bg, partner_bank] = get_refresh_partner(addr_vec[m_levels["bankgroup"]], addr_vec[m_levels["bank"]]);
+        epoch += channel->m_child_nodes[rank_id]->m_child_nodes[partner_bg]->m_child_nodes[partner_bank]->m_subtree_epoch;
+      }
+      return epoch;
+    };
+
   private:
     void set_organization() {
       // Channel width
@@ -399,6 +636,16 @@ class LPDDR6 : public IDRAM, public Implementation {
         m_organization.density = *density;
       }
 
+      // In 16-bank mode, all banks of a rank form a single bank group without the bank-group timings
+      std::string bank_mode = param_group("org").param<std::string>("bank_mode").desc("Bank architecture (BG: bank groups, 16B: 16 banks without bank groups).").default_val("BG");
+      if (bank_mode == "16B") {
+        m_organization.count[m_levels["bank"]] *= m_organization.count[m_levels["bankgroup"]];
+        m_organization.count[m_levels["bankgroup"]] = 1;
+        m_is_bg_mode = false;
+      } else if (bank_mode != "BG") {
+        throw ConfigurationError("Unrecognized bank mode \"{}\" in {}!", bank_mode, get_name());
+      }
+
       // Sanity check: is the calculated chip density the same as the provided one?
       size_t _density = size_t(m_organization.count[m_levels["bankgroup"]]) *
                         size_t(m_organization.count[m_levels["bank"]]) *
@@ -416,6 +663,75 @@ class LPDDR6 : public IDRAM, public Implementation {
 
     };
 
+    /**
+     * @brief    Sets up what the non-data bits of a burst carry.
+     * @details
+     * A burst of an x12 sub-channel has 288 bits: 256 data bits and 32 bits that carry either host metadata
+     * or link ECC. Only the data bits are addressable, while the metadata bits also count as payload.
+     */
+    void set_metadata() {
+      int burst_bits = m_internal_prefetch_size * m_channel_width;
+      std::optional<int> non_data_bits;
+      if (m_config["metadata"]) {
+        non_data_bits = param_group("metadata").param<int>("non_data_bits").desc("Number of non-data bits per burst (metadata and link ECC). Defaults to 32 for a x12 channel.").optional();
+      }
+      if (!non_data_bits) {
+        if (burst_bits != X12_BURST_BITS) {
+          throw ConfigurationError("The non-data bits of a {}-bit burst of {} are unknown, specify metadata.non_data_bits!", burst_bits, get_name());
+        }
+        non_data_bits = X12_NON_DATA_BITS;
+      }
+      if (*non_data_bits < 0 || *non_data_bits >= burst_bits) {
+        throw ConfigurationError("The number of non-data bits ({}) of {} must be between 0 and {}!", *non_data_bits, get_name(), burst_bits - 1);
+      }
+      m_tx_overhead_bits = *non_data_bits;
+
+      if (!m_config["metadata"] || !param_group("metadata").param<bool>("enable").desc("Whether the non-data bits of a burst carry host metadata instead of link ECC.").default_val(false)) {
+        return;
+      }
+      m_metadata_bits = param_group("metadata").param<int>("bits").desc("Number of metadata bits per burst (the rest carry link ECC).").default_val(m_tx_overhead_bits);
+      if (m_metadata_bits < 0 || m_metadata_bits > m_tx_overhead_bits) {
+        throw ConfigurationError("The number of metadata bits ({}) of {} must be between 0 and {}!", m_metadata_bits, get_name(), m_tx_overhead_bits);
+      }
+    };
+
+    void set_wck_mode() {
+      std::string wck_mode = param<std::string>("wck_mode").desc("WCK mode (AlwaysOn or OnDemand). An on-demand WCK has to be synced by a CAS command before a RD/WR once it has stopped.").default_val("AlwaysOn");
+      if (wck_mode == "AlwaysOn") {
+        m_wck_always_on = true;
+      } else if (wck_mode == "OnDemand") {
+        m_wck_always_on = false;
+      } else {
+        throw ConfigurationError("Unrecognized WCK mode \"{}\" in {}!", wck_mode, get_name());
+      }
+    };
+
+    void set_bus_stats() {
+      m_bus_stats.resize(m_organization.count[m_levels["channel"]]);
+      for (int i = 0; i < m_bus_stats.size(); i++) {
+        register_stat(m_bus_stats[i].payload_bytes).name("payload_bytes_{}", i);
+        register_stat(m_bus_stats[i].raw_bytes).name("raw_bytes_{}", i);
+        register_stat(m_bus_stats[i].payload_bus_utilization).name("payload_bus_utilization_{}", i);
+        register_stat(m_bus_stats[i].raw_bus_utilization).name("raw_bus_utilization_{}", i);
+        register_stat(m_bus_stats[i].payload_bandwidth).name("payload_bandwidth_{}", i);
+      }
+    };
+
+    void process_bus_stats(BusStats& bus_stats) {
+      int raw_bits = m_internal_prefetch_size * m_channel_width;
+      int payload_bits = raw_bits - m_tx_overhead_bits + m_metadata_bits;
+
+      bus_stats.raw_bytes = bus_stats.num_bursts * raw_bits / 8;
+      bus_stats.payload_bytes = bus_stats.num_bursts * payload_bits / 8;
+      if (m_clk == 0) {
+        return;
+      }
+      bus_stats.raw_bus_utilization = (double) bus_stats.num_bursts * m_timing_vals("nBL24") / m_clk;
+      bus_stats.payload_bus_utilization = bus_stats.raw_bus_utilization * payload_bits / raw_bits;
+      // Bytes per picosecond to GB/s
+      bus_stats.payload_bandwidth = (double) bus_stats.payload_bytes / (m_clk * m_timing_vals("tCK_ps")) * 1E3;
+    };
+
     void set_timing_vals() {
       m_timing_vals.resize(m_timings.size(), -1);
 
@@ -443,7 +759,7 @@ class LPDDR6 : public IDRAM, public Implementation {
       // Load the organization specific timings
       int dq_id = [](int dq) -> int {
         switch (dq) {
-          case 16: return 0;
+          case 12: return 0;
           default: return -1;
         }
       }(m_organization.dq);
@@ -455,7 +771,6 @@ class LPDDR6 : public IDRAM, public Implementation {
         }
       }(m_timing_vals("rate"));
 
-
       // Refresh timings
 
       // tREFI(base) table (unit is nanosecond!)
@@ -466,26 +781,69 @@ class LPDDR6 : public IDRAM, public Implementation {
           case 4096:  return 1;
           case 8192:  return 2;
           case 16384: return 3;
+          case 32768: return 4;
           default:    return -1;
         }
       }(m_organization.density);
+      if (density_id == -1) {
+        throw ConfigurationError("Unsupported {} chip density {} Mb!", get_name(), m_organization.density);
+      }
 
       m_timing_vals("nREFI") = JEDEC_rounding(tREFI_BASE, tCK_ps);
 
+      // tRFCab and tRFCpb tables (unit is nanosecond!)
+      constexpr float tRFCab_TABLE[]   = {130, 180, 210, 280, 380};
+      constexpr float tRFCpb_TABLE[]   = {60, 90, 120, 140, 190};
+      m_timing_vals("nRFCab")   = JEDEC_rounding(tRFCab_TABLE[density_id], tCK_ps);
+
+      // Per-bank refresh timings (unit is nanosecond!)
+      constexpr float tPBR2PBR_TABLE[] = {60, 90, 90,  90,  90};
+      m_timing_vals("nRFCpb")   = JEDEC_rounding(tRFCpb_TABLE[density_id], tCK_ps);
+      m_timing_vals("nPBR2PBR") = JEDEC_rounding(tPBR2PBR_TABLE[density_id], tCK_ps);
+      m_timing_vals("nPBR2ACT") = JEDEC_rounding(7.5, tCK_ps);
+
+      // Power-down and self-refresh timings (unit is nanosecond!)
+      // tXSR is tRFCab + 7.5ns, so it depends on the density
+      m_timing_vals("nCKE") = JEDEC_rounding(7.5, tCK_ps);
+      m_timing_vals("nXP")  = JEDEC_rounding(7.5, tCK_ps);
+      m_timing_vals("nSR")  = JEDEC_rounding(15.0, tCK_ps);
+      m_timing_vals("nXSR") = JEDEC_rounding(tRFCab_TABLE[density_id] + 7.5, tCK_ps);
+
+      // WCK enable and static preamble from a CAS with WCK sync to the first RD/WR (unit is nanosecond!)
+      constexpr float tWCKSYNC = 3.75;
+      if (m_timing_vals("nWCKSYNC") == -1) {
+        m_timing_vals("nWCKSYNC") = JEDEC_rounding(tWCKSYNC, tCK_ps);
+      }
+
       // Overwrite timing parameters with any user-provided value
       // Rate and tCK should not be overwritten
+      std::vector<bool> is_provided(m_timings.size(), false);
       for (int i = 1; i < m_timings.size() - 1; i++) {
         auto timing_name = std::string(m_timings(i));
 
         if (auto provided_timing = param_group("timing").param<int>(timing_name).optional()) {
           // Check if the user specifies in the number of cycles (e.g., nRCD)
           m_timing_vals(i) = *provided_timing;
+          is_provided[i] = true;
         } else if (auto provided_timing = param_group("timing").param<float>(timing_name.replace(0, 1, "t")).optional()) {
           // Check if the user specifies in nanoseconds (e.g., tRCD)
           m_timing_vals(i) = JEDEC_rounding(*provided_timing, tCK_ps);
+          is_provided[i] = true;
         }
       }
 
+      // Without bank groups, all banks are in the same bank group, so the bank-group rules (nCCD_L, nWTR_L) space
+      // every pair of CAS commands and the _S timings have no effect
+      if (!m_is_bg_mode) {
+        for (auto timing : {"nCCD_S", "nWTR_S"}) {
+          if (is_provided[m_timings(timing)]) {
+            spdlog::warn("[{}] {} is ignored in the 16B bank mode, where the _L timing applies to all banks.", get_name(), timing);
+          }
+        }
+        m_timing_vals("nCCD_S") = m_timing_vals("nCCD_L");
+        m_timing_vals("nWTR_S") = m_timing_vals("nWTR_L");
+      }
+
       // Check if there is any uninitialized timings
       for (int i = 0; i < m_timing_vals.size(); i++) {
         if (m_timing_vals(i) == -1) {
@@ -503,30 +861,59 @@ class LPDDR6 : public IDRAM, public Implementation {
           /*** Channel ***/ 
           // CAS <-> CAS
           /// Data bus occupancy
-          {.level = "channel", .preceding = {"RD24"}, .following = {"RD24", "RD24A"}, .latency = V("nBL24") - 1},
-          {.level = "channel", .preceding = {"WR24"}, .following = {"WR24", "WR24A"}, .latency = V("nBL24") - 1},
+          {.level = "channel", .preceding = {"RD24", "RD24A"}, .following = {"RD24", "RD24A"}, .latency = V("nBL24") - 1},
+          {.level = "channel", .preceding = {"WR24", "WR24A"}, .following = {"WR24", "WR24A"}, .latency = V("nBL24") - 1},
 
           /*** Rank (or different BankGroup) ***/ 
           // CAS <-> CAS
-          {.level = "rank", .preceding = {"RD24"}, .following = {"RD24", "RD24A"}, .latency = V("nCCD_S") - 1},
-          {.level = "rank", .preceding = {"WR24"}, .following = {"WR24", "WR24A"}, .latency = V("nCCD_S") - 1},
+          {.level = "rank", .preceding = {"RD24", "RD24A"}, .following = {"RD24", "RD24A"}, .latency = V("nCCD_S") - 1},
+          {.level = "rank", .preceding = {"WR24", "WR24A"}, .following = {"WR24", "WR24A"}, .latency = V("nCCD_S") - 1},
           /// RD <-> WR, Minimum Read to Write                      
-          {.level = "rank", .preceding = {"RD24"}, .following = {"WR24", "WR24A"}, .latency = V("nCL") + V("nCCD_S") + 2 - V("nCWL") - 1},
+          {.level = "rank", .preceding = {"RD24", "RD24A"}, .following = {"WR24", "WR24A"}, .latency = V("nCL") + V("nCCD_S") + 2 - V("nCWL") - 1},
           /// WR <-> RD, Minimum Read after Write
-          {.level = "rank", .preceding = {"WR24"}, .following = {"RD24", "RD24A"}, .latency = V("nCWL") + V("nCCD_S") + V("nWTR_S") - 1},     
+          {.level = "rank", .preceding = {"WR24", "WR24A"}, .following = {"RD24", "RD24A"}, .latency = V("nCWL") + V("nCCD_S") + V("nWTR_S") - 1},     
+          /// CAS-WCK sync <-> CAS, the WCK has to be enabled and past its static preamble
+          {.level = "rank", .preceding = {"CASRD", "CASWR"}, .following = {"RD24", "RD24A", "WR24", "WR24A"}, .latency = V("nWCKSYNC") - 1},
           /// RAS <-> RAS
           {.level = "rank", .preceding = {"ACT-1"}, .following = {"ACT-1"}, .latency = V("nRRD") - 1},          
           {.level = "rank", .preceding = {"ACT-1"}, .following = {"ACT-1"}, .latency = V("nFAW") - 1, .window = 4},
           {.level = "rank", .preceding = {"PRE", "PREA"}, .following = {"PRE", "PREA"}, .latency = 4 - 1},
+          /// RAS/CAS <-> PREA (PREA is checked at the rank only, so it has to wait for tRAS and the read/write recovery of every bank)
+          {.level = "rank", .preceding = {"ACT-2"}, .following = {"PREA"}, .latency = V("nRAS") - 1},
+          {.level = "rank", .preceding = {"RD24"}, .following = {"PREA"}, .latency = V("nRTP") - 1},
+          {.level = "rank", .preceding = {"WR24"}, .following = {"PREA"}, .latency = V("nCWL") + V("nCCD_L") + V("nWTP") - 1},
+          /// RAS <-> REFpb (a per-bank refresh counts as an ACT for tRRD)
+          {.level = "rank", .preceding = {"ACT-1"}, .following = {"REFpb", "RFMpb"}, .latency = V("nRRD") - 1},
+          {.level = "rank", .preceding = {"REFpb", "RFMpb"}, .following = {"ACT-1"}, .latency = V("nPBR2ACT") - 1},
+          {.level = "rank", .preceding = {"REFpb", "RFMpb"}, .following = {"REFpb", "RFMpb"}, .latency = V("nPBR2PBR") - 1},
+          {.level = "rank", .preceding = {"REFpb", "RFMpb"}, .following = {"REFab", "RFMab", "PDE", "SRE"}, .latency = V("nRFCpb") - 1},
+          /// RAS <-> REFab (the rank is busy for tRFCab)
+          {.level = "rank", .preceding = {"PRE"}, .following = {"REFab", "RFMab"}, .latency = V("nRPpb") - 1},
+          {.level = "rank", .preceding = {"PREA"}, .following = {"REFab", "RFMab"}, .latency = V("nRPab") - 1},
+          {.level = "rank", .preceding = {"REFab", "RFMab"}, .following = {"ACT-1"}, .latency = V("nRFCab") - 2 - 1},
+          {.level = "rank", .preceding = {"REFab", "RFMab"}, .following = {"REFab", "RFMab", "REFpb", "RFMpb", "PDE", "SRE"}, .latency = V("nRFCab") - 1},
+          /// Power-down and self-refresh entry (after the last data burst and precharge)
+          {.level = "rank", .preceding = {"RD24"}, .following = {"PDE", "SRE"}, .latency = V("nCL") + V("nBL24") + 1 - 1},
+          {.level = "rank", .preceding = {"WR24"}, .following = {"PDE", "SRE"}, .latency = V("nCWL") + V("nBL24") + V("nWTP") - 1},
+          {.level = "rank", .preceding = {"PRE"}, .following = {"PDE", "SRE"}, .latency = V("nRPpb") - 1},
+          {.level = "rank", .preceding = {"PREA"}, .following = {"PDE", "SRE"}, .latency = V("nRPab") - 1},
+          /// Auto-precharge completes tRTP (read) or the write recovery (write) plus tRPpb after the CAS
+          {.level = "rank", .preceding = {"RD24A"}, .following = {"PDE", "SRE", "REFab", "RFMab"}, .latency = std::max(V("nCL") + V("nBL24") + 1, V("nRTP") + V("nRPpb")) - 1},
+          {.level = "rank", .preceding = {"WR24A"}, .following = {"PDE", "SRE", "REFab", "RFMab"}, .latency = V("nCWL") + V("nCCD_L") + V("nWTP") + V("nRPpb") - 1},
+          /// Minimum residency and exit latency
+          {.level = "rank", .preceding = {"PDE"}, .following = {"PDX"}, .latency = V("nCKE") - 1},
+          {.level = "rank", .preceding = {"SRE"}, .following = {"SRX"}, .latency = V("nSR") - 1},
+          {.level = "rank", .preceding = {"PDX"}, .following = {"ACT-1", "PRE", "PREA", "RD24", "WR24", "RD24A", "WR24A", "CASRD", "CASWR", "REFab", "REFpb", "RFMab", "RFMpb", "PDE", "SRE"}, .latency = V("nXP") - 1},
+          {.level = "rank", .preceding = {"SRX"}, .following = {"ACT-1", "PRE", "PREA", "RD24", "WR24", "RD24A", "WR24A", "CASRD", "CASWR", "REFab", "REFpb", "RFMab", "RFMpb", "PDE", "SRE"}, .latency = V("nXSR") - 1},
 
           /*** Same Bank Group ***/ 
           /// CAS <-> CAS
-          {.level = "bankgroup", .preceding = {"RD24"}, .following = {"RD24", "RD24A"}, .latency = V("nBL24") - 1},          
-          {.level = "bankgroup", .preceding = {"WR24"}, .following = {"WR24", "WR24A"}, .latency = V("nBL24") - 1},       
+          {.level = "bankgroup", .preceding = {"RD24", "RD24A"}, .following = {"RD24", "RD24A"}, .latency = V("nCCD_L") - 1},          
+          {.level = "bankgroup", .preceding = {"WR24", "WR24A"}, .following = {"WR24", "WR24A"}, .latency = V("nCCD_L") - 1},       
           /// RD <-> WR, Minimum Read to Write                      
-          {.level = "bankgroup", .preceding = {"RD24"}, .following = {"WR24", "WR24A"}, .latency = V("nCL") + V("nCCD_L") + 2 - V("nCWL") - 1}, 
+          {.level = "bankgroup", .preceding = {"RD24", "RD24A"}, .following = {"WR24", "WR24A"}, .latency = V("nCL") + V("nCCD_L") + 2 - V("nCWL") - 1}, 
           /// WR <-> RD, Minimum Read after Write  
-          {.level = "bankgroup", .preceding = {"WR24"}, .following = {"RD24", "RD24A"}, .latency = V("nCWL") + V("nCCD_L") + V("nWTR_L") - 1},
+          {.level = "bankgroup", .preceding = {"WR24", "WR24A"}, .following = {"RD24", "RD24A"}, .latency = V("nCWL") + V("nCCD_L") + V("nWTR_L") - 1},
           /// RAS <-> RAS
           {.level = "bankgroup", .preceding = {"ACT-1"}, .following = {"ACT-1"}, .latency = V("nRRD") - 1},  
           {.level = "bankgroup", .preceding = {"PRE", "PREA"}, .following = {"PRE", "PREA"}, .latency = 4 - 1},
@@ -543,118 +930,289 @@ class LPDDR6 : public IDRAM, public Implementation {
           {.level = "bank", .preceding = {"WR24"}, .following = {"PRE", "PREA"}, .latency = V("nCWL") + V("nCCD_L") + V("nWTP") - 1},  
           {.level = "bank", .preceding = {"PRE"}, .following = {"ACT-1"}, .latency = V("nRPpb") - 2 - 1}, // 实际约束的是到ACT-2的时间
           {.level = "bank", .preceding = {"PREA"}, .following = {"ACT-1"}, .latency = V("nRPab") - 2 - 1}, // 实际约束的是到ACT-2的时间
-          {.level = "bank", .preceding = {"PRE", "PREA"}, .following = {"PRE", "PREA"}, .latency = 4 - 1}
+          {.level = "bank", .preceding = {"PRE", "PREA"}, .following = {"PRE", "PREA"}, .latency = 4 - 1},
+          /// Auto-precharge: the implicit PRE waits for tRAS and tRTP (read) or the write recovery (write), and the next ACT for tRPpb
+          {.level = "bank", .preceding = {"ACT-2"}, .following = {"ACT-1"}, .latency = (V("nRAS") - 1) + (V("nRPpb") - 2 - 1)},
+          {.level = "bank", .preceding = {"RD24A"}, .following = {"ACT-1"}, .latency = V("nRTP") + V("nRPpb") - 2 - 1},
+          {.level = "bank", .preceding = {"WR24A"}, .following = {"ACT-1"}, .latency = V("nCWL") + V("nCCD_L") + V("nWTP") + V("nRPpb") - 2 - 1},
+          /// Per-bank refresh (applied to both banks of the refreshed pair)
+          {.level = "bank", .preceding = {"PRE"}, .following = {"REFpb", "RFMpb"}, .latency = V("nRPpb") - 1},
+          {.level = "bank", .preceding = {"PREA"}, .following = {"REFpb", "RFMpb"}, .latency = V("nRPab") - 1},
+          {.level = "bank", .preceding = {"RD24A"}, .following = {"REFpb", "RFMpb"}, .latency = V("nRTP") + V("nRPpb") - 1},
+          {.level = "bank", .preceding = {"WR24A"}, .following = {"REFpb", "RFMpb"}, .latency = V("nCWL") + V("nCCD_L") + V("nWTP") + V("nRPpb") - 1},
+          {.level = "bank", .preceding = {"REFpb", "RFMpb"}, .following = {"ACT-1"}, .latency = V("nRFCpb") - 2 - 1},
         }
       );
       #undef V
 
     };
 
-    void set_actions() {
-      m_actions.resize(m_levels.size(), std::vector<ActionFunc_t<Node>>(m_commands.size()));
+    /**
+     * @brief    Returns the command that wakes up the rank, or -1 if it is not in power-down or self-refresh.
+     */
+    static int get_wakeup_command(Node* rank) {
+      switch (rank->m_state) {
+        case m_states["Power-Down"]:   return m_commands["PDX"];
+        case m_states["Self-Refresh"]: return m_commands["SRX"];
+        default:                       return -1;
+      }
+    };
 
-      // Rank Actions
-      m_actions[m_levels["rank"]][m_commands["PREA"]] = Lambdas::Action::Rank::PREab<LPDDR6>;
-      m_actions[m_levels["rank"]][m_commands["RD24"]] = [this] (Node* node, int cmd, int target_id, Clk_t clk) {
-        m_final_synced_cycle = clk + m_timing_vals("nCL") + m_timing_vals("nBL24") + m_timing_vals("nWCKPST"); 
-      };
-      m_actions[m_levels["rank"]][m_commands["WR24"]] = [this] (Node* node, int cmd, int target_id, Clk_t clk) {
-        m_final_synced_cycle = clk + m_timing_vals("nCWL") + m_timing_vals("nBL24") + m_timing_vals("nWCKPST"); 
-      };
-      // Bank actions
-      m_actions[m_levels["bank"]][m_commands["ACT-1"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
-        node->m_state = m_states["Pre-Opened"];
-        node->m_row_state[target_id] = m_states["Pre-Opened"];
-      };
-      m_actions[m_levels["bank"]][m_commands["ACT-2"]] = Lambdas::Action::Bank::ACT<LPDDR6>;
-      m_actions[m_levels["bank"]][m_commands["PRE"]]   = Lambdas::Action::Bank::PRE<LPDDR6>;
+    static bool is_wck_command(int command) {
+      switch (command) {
+        case m_commands["RD24"]: case m_commands["RD24A"]: case m_commands["WR24"]: case m_commands["WR24A"]:
+        case m_commands["CASRD"]: case m_commands["CASWR"]:
+          return true;
+        default:
+          return false;
+      }
+    };
 
-      // TODO: read/write + PRE 
-      // m_actions[m_levels["bank"]][m_commands["RD24A"]] = Lambdas::Action::Bank::PRE<LPDDR6>;
-      // m_actions[m_levels["bank"]][m_commands["WR24A"]] = Lambdas::Action::Bank::PRE<LPDDR6>;
+    static bool is_per_bank_refresh(int command) {
+      return command == m_commands["REFpb"] || command == m_commands["RFMpb"];
     };
 
-    void set_preqs() {
-      m_preqs.resize(m_levels.size(), std::vector<PreqFunc_t<Node>>(m_commands.size()));
+    /**
+     * @brief    Returns the bankgroup and bank that a per-bank refresh to the given bank refreshes along with it.
+     * @details  Banks are paired with the bank half a rank away (e.g., banks b and b+8 of 16 banks).
+     */
+    std::pair<int, int> get_refresh_partner(int bankgroup, int bank) const {
+      int num_banks = m_organization.count[m_levels["bank"]];
+      int num_banks_per_rank = m_organization.count[m_levels["bankgroup"]] * num_banks;
+      int partner_id = (bankgroup * num_banks + bank + num_banks_per_rank / 2) % num_banks_per_rank;
+      return {partner_id / num_banks, partner_id % num_banks};
+    };
 
-      // Rank Preqs
-      m_preqs[m_levels["rank"]][m_commands["REFab"]] = Lambdas::Preq::Rank::RequireAllBanksClosed<LPDDR6>;
-      m_preqs[m_levels["rank"]][m_commands["RFMab"]] = Lambdas::Preq::Rank::RequireAllBanksClosed<LPDDR6>;
+    AddrVec_t get_refresh_partner_addr(const AddrVec_t& addr_vec) const {
+      AddrVec_t partner_addr_vec = addr_vec;
+      std::tie(partner_addr_vec[m_levels["bankgroup"]], partner_addr_vec[m_levels["bank"]]) =
+        get_refresh_partner(addr_vec[m_levels["bankgroup"]], addr_vec[m_levels["bank"]]);
+      return partner_addr_vec;
+    };
 
-      m_preqs[m_levels["rank"]][m_commands["REFpb"]] = [this] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+    /**
+     * @brief    Returns the earliest cycle the timing constraints allow the command, regardless of the command bus.
+     * @details  A per-bank refresh has to satisfy the bank timings of both banks of the pair.
+     */
+    Clk_t get_timing_ready_clk(int command, const AddrVec_t& addr_vec) {
+      int channel_id = addr_vec[m_levels["channel"]];
+      Clk_t ready_clk = m_channels[channel_id]->get_ready_clk(command, addr_vec);
+      if (is_per_bank_refresh(command)) {
+        ready_clk = std::max(ready_clk, m_channels[channel_id]->get_ready_clk(command, get_refresh_partner_addr(addr_vec)));
+      }
+      return ready_clk;
+    };
 
-        for (auto bg : node->m_child_nodes) {
-          for (auto bank : bg->m_child_nodes) {
-            int num_banks_per_bg = m_organization.count[m_levels["bank"]];
-            int flat_bankid = bank->m_node_id + bg->m_node_id * num_banks_per_bg;
-            if (flat_bankid == addr_vec[LPDDR6::m_levels["bank"]] || flat_bankid == addr_vec[LPDDR6::m_levels["bank"]] + 8) {
-              switch (node->m_state) {
-                case m_states["Pre-Opened"]: return m_commands["PRE"];
-                case m_states["Opened"]: return m_commands["PRE"];
-              }
-            }
-          }
+    void set_powers() {
+      m_drampower_enable = param<bool>("drampower_enable").desc("Whether to enable the power model.").default_val(false);
+
+      if (!m_drampower_enable)
+        return;
+
+      m_voltage_vals.resize(m_voltages.size(), -1);
+      if (auto preset_name = param_group("voltage").param<std::string>("preset").optional()) {
+        if (voltage_presets.count(*preset_name) > 0) {
+          m_voltage_vals = voltage_presets.at(*preset_name);
+        } else {
+          throw ConfigurationError("Unrecognized voltage preset \"{}\" in {}!", *preset_name, get_name());
+        }
+      }
+      for (int i = 0; i < m_voltages.size(); i++) {
+        if (auto provided_voltage = param_group("voltage").param<double>(std::string(m_voltages(i))).optional()) {
+          m_voltage_vals(i) = *provided_voltage;
+        }
+        if (m_voltage_vals(i) < 0) {
+          throw ConfigurationError("In \"{}\", voltage {} is not specified!", get_name(), m_voltages(i));
         }
+      }
 
-        return cmd;
-      };
-      
-      m_preqs[m_levels["rank"]][m_commands["RFMpb"]] = m_preqs[m_levels["rank"]][m_commands["REFpb"]];
-
-      // Bank Preqs
-      m_preqs[m_levels["bank"]][m_commands["RD24"]] = [this] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-        switch (node->m_state) {
-          case m_states["Closed"]: return m_commands["ACT-1"];
-          case m_states["Pre-Opened"]: return m_commands["ACT-2"];
-          case m_states["Opened"]: {
-            if (node->m_row_state.find(addr_vec[m_levels["row"]]) != node->m_row_state.end()) {
-              Node* rank = node->m_parent_node->m_parent_node;
-              return cmd;
-            } else {
-              return m_commands["PRE"];
-            }
-          }    
-          default: {
-            spdlog::error("[Preq::Bank] Invalid bank state for an RD/WR command!");
-            std::exit(-1);      
-          } 
+      m_current_vals.resize(m_currents.size(), -1);
+      if (auto preset_name = param_group("current").param<std::string>("preset").optional()) {
+        if (current_presets.count(*preset_name) > 0) {
+          m_current_vals = current_presets.at(*preset_name);
+        } else {
+          throw ConfigurationError("Unrecognized current preset \"{}\" in {}!", *preset_name, get_name());
         }
-      };
-      m_preqs[m_levels["bank"]][m_commands["WR24"]] = [this] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-        switch (node->m_state) {
-          case m_states["Closed"]: return m_commands["ACT-1"];
-          case m_states["Pre-Opened"]: return m_commands["ACT-2"];
-          case m_states["Opened"]: {
-            if (node->m_row_state.find(addr_vec[m_levels["row"]]) != node->m_row_state.end()) {
-              Node* rank = node->m_parent_node->m_parent_node;
-              return cmd;
-            } else {
-              return m_commands["PRE"];
-            }
-          }    
-          default: {
-            spdlog::error("[Preq::Bank] Invalid bank state for an RD/WR command!");
-            std::exit(-1);      
-          } 
+      }
+      for (int i = 0; i < m_currents.size(); i++) {
+        if (auto provided_current = param_group("current").param<double>(std::string(m_currents(i))).optional()) {
+          m_current_vals(i) = *provided_current;
         }
-      };
+        if (m_current_vals(i) < 0) {
+          throw ConfigurationError("In \"{}\", current {} is not specified!", get_name(), m_currents(i));
+        }
+      }
+
+      int num_channels = m_organization.count[m_levels["channel"]];
+      int num_ranks = m_organization.count[m_levels["rank"]];
+      int num_banks_per_rank = m_organization.count[m_levels["bankgroup"]] * m_organization.count[m_levels["bank"]];
+      if (num_banks_per_rank > 64) {
+        throw ConfigurationError("The power model of {} supports at most 64 banks per rank!", get_name());
+      }
+
+      m_power_stats.resize(num_channels * num_ranks);
+      for (int i = 0; i < num_channels * num_ranks; i++) {
+        m_power_stats[i].rank_id = i;
+        m_power_stats[i].cmd_counters.resize(m_cmds_counted.size(), 0);
+      }
+
+      register_stat(s_total_background_energy).name("total_background_energy");
+      register_stat(s_total_cmd_energy).name("total_cmd_energy");
+      register_stat(s_total_energy).name("total_energy");
+      for (auto& power_stat : m_power_stats) {
+        register_stat(power_stat.total_background_energy).name("total_background_energy_rank{}", power_stat.rank_id);
+        register_stat(power_stat.total_cmd_energy).name("total_cmd_energy_rank{}", power_stat.rank_id);
+        register_stat(power_stat.total_energy).name("total_energy_rank{}", power_stat.rank_id);
+        register_stat(power_stat.act_background_energy).name("act_background_energy_rank{}", power_stat.rank_id);
+        register_stat(power_stat.pre_background_energy).name("pre_background_energy_rank{}", power_stat.rank_id);
+        register_stat(power_stat.pd_background_energy).name("pd_background_energy_rank{}", power_stat.rank_id);
+        register_stat(power_stat.sr_background_energy).name("sr_background_energy_rank{}", power_stat.rank_id);
+        register_stat(power_stat.wck_energy).name("wck_energy_rank{}", power_stat.rank_id);
+        register_stat(power_stat.active_cycles).name("active_cycles_rank{}", power_stat.rank_id);
+        register_stat(power_stat.idle_cycles).name("idle_cycles_rank{}", power_stat.rank_id);
+        register_stat(power_stat.power_down_cycles).name("power_down_cycles_rank{}", power_stat.rank_id);
+        register_stat(power_stat.self_refresh_cycles).name("self_refresh_cycles_rank{}", power_stat.rank_id);
+        register_stat(power_stat.wck_cycles).name("wck_cycles_rank{}", power_stat.rank_id);
+      }
     };
 
-    void set_rowhits() {
-      m_rowhits.resize(m_levels.size(), std::vector<RowhitFunc_t<Node>>(m_commands.size()));
+    /**
+     * @brief    Records a command in the power model of its rank.
+     * @details
+     * Instead of walking the node tree, every rank keeps a bitmask of its banks that are not precharged
+     * and the command counters. Background cycles are only integrated when the rank switches between
+     * idle, active, power-down and self-refresh (and once more at finalize()), so the cost per command
+     * is a few bit operations.
+     */
+    void update_power(int command, const AddrVec_t& addr_vec) {
+      int num_ranks = m_organization.count[m_levels["rank"]];
+      PowerStats& rank_stats = m_power_stats[addr_vec[m_levels["channel"]] * num_ranks + addr_vec[m_levels["rank"]]];
+
+      uint64_t bank_bit = 0;
+      if (addr_vec[m_levels["bankgroup"]] >= 0 && addr_vec[m_levels["bank"]] >= 0) {
+        bank_bit = uint64_t(1) << (addr_vec[m_levels["bankgroup"]] * m_organization.count[m_levels["bank"]] + addr_vec[m_levels["bank"]]);
+      }
 
-      m_rowhits[m_levels["bank"]][m_commands["RD24"]] = Lambdas::RowHit::Bank::RDWR<LPDDR6>;
-      m_rowhits[m_levels["bank"]][m_commands["WR24"]] = Lambdas::RowHit::Bank::RDWR<LPDDR6>;
-    }
+      uint64_t active_banks = rank_stats.active_bank_mask;
+      PowerStats::PowerState power_state = rank_stats.cur_power_state;
+      auto& counters = rank_stats.cmd_counters;
+      switch (command) {
+        case m_commands["ACT-1"]: active_banks |= bank_bit; break;
+        case m_commands["ACT-2"]: counters[m_cmds_counted["ACT"]]++; break;
+        case m_commands["PRE"]: {
+          if (active_banks & bank_bit) {
+            counters[m_cmds_counted["PRE"]]++;
+            active_banks &= ~bank_bit;
+          }
+          break;
+        }
+        case m_commands["PREA"]: {
+          counters[m_cmds_counted["PRE"]] += std::popcount(active_banks);
+          active_banks = 0;
+          break;
+        }
+        case m_commands["RD24"]: counters[m_cmds_counted["RD"]]++; break;
+        case m_commands["WR24"]: counters[m_cmds_counted["WR"]]++; break;
+        case m_commands["RD24A"]: {
+          counters[m_cmds_counted["RD"]]++;
+          counters[m_cmds_counted["PRE"]]++;
+          active_banks &= ~bank_bit;
+          break;
+        }
+        case m_commands["WR24A"]: {
+          counters[m_cmds_counted["WR"]]++;
+          counters[m_cmds_counted["PRE"]]++;
+          active_banks &= ~bank_bit;
+          break;
+        }
+        // An RFM occupies the banks as long as a refresh of the same scope
+        case m_commands["REFab"]: case m_commands["RFMab"]: counters[m_cmds_counted["REFab"]]++; break;
+        case m_commands["REFpb"]: case m_commands["RFMpb"]: counters[m_cmds_counted["REFpb"]]++; break;
+        case m_commands["PDE"]: power_state = PowerStats::PowerState::POWER_DOWN; break;
+        case m_commands["SRE"]: power_state = PowerStats::PowerState::SELF_REFRESH; break;
+        case m_commands["PDX"]: case m_commands["SRX"]: power_state = PowerStats::PowerState::IDLE; break;
+        default: break;
+      }
 
+      if (power_state != PowerStats::PowerState::POWER_DOWN && power_state != PowerStats::PowerState::SELF_REFRESH) {
+        power_state = active_banks ? PowerStats::PowerState::ACTIVE : PowerStats::PowerState::IDLE;
+      }
+      rank_stats.active_bank_mask = active_banks;
+      if (power_state != rank_stats.cur_power_state) {
+        integrate_power_state(rank_stats);
+        rank_stats.cur_power_state = power_state;
+      }
+    };
 
-    void set_rowopens() {
-      m_rowopens.resize(m_levels.size(), std::vector<RowhitFunc_t<Node>>(m_commands.size()));
+    /**
+     * @brief    Adds the cycles since the rank entered its current power state to the counter of that state.
+     */
+    void integrate_power_state(PowerStats& rank_stats) {
+      Clk_t cycles = m_clk - rank_stats.state_start_cycle;
+      switch (rank_stats.cur_power_state) {
+        case PowerStats::PowerState::ACTIVE:       rank_stats.active_cycles += cycles; break;
+        case PowerStats::PowerState::POWER_DOWN:   rank_stats.power_down_cycles += cycles; break;
+        case PowerStats::PowerState::SELF_REFRESH: rank_stats.self_refresh_cycles += cycles; break;
+        default:                                   rank_stats.idle_cycles += cycles; break;
+      }
+      rank_stats.state_start_cycle = m_clk;
+    };
 
-      m_rowopens[m_levels["bank"]][m_commands["RD24"]] = Lambdas::RowOpen::Bank::RDWR<LPDDR6>;
-      m_rowopens[m_levels["bank"]][m_commands["WR24"]] = Lambdas::RowOpen::Bank::RDWR<LPDDR6>;
-    }
+    /**
+     * @brief    Adds the cycles by which a RD/WR or CAS command extends the synced WCK window of its rank.
+     */
+    void update_wck_power(const AddrVec_t& addr_vec) {
+      int num_ranks = m_organization.count[m_levels["rank"]];
+      PowerStats& rank_stats = m_power_stats[addr_vec[m_levels["channel"]] * num_ranks + addr_vec[m_levels["rank"]]];
+
+      Clk_t final_synced_cycle = m_channels[addr_vec[m_levels["channel"]]]->m_child_nodes[addr_vec[m_levels["rank"]]]->m_final_synced_cycle;
+      if (final_synced_cycle > rank_stats.wck_synced_cycle) {
+        rank_stats.wck_cycles += final_synced_cycle - std::max(rank_stats.wck_synced_cycle, m_clk);
+        rank_stats.wck_synced_cycle = final_synced_cycle;
+      }
+    };
+
+    void process_rank_energy(PowerStats& rank_stats) {
+      // Integrate the last period up to the end of the simulation
+      integrate_power_state(rank_stats);
+      if (m_wck_always_on) {
+        // WCK only stops in power-down and self-refresh
+        rank_stats.wck_cycles = rank_stats.active_cycles + rank_stats.idle_cycles;
+      } else if (rank_stats.wck_synced_cycle > m_clk) {
+        rank_stats.wck_cycles -= rank_stats.wck_synced_cycle - m_clk;
+      }
 
+      auto TS = [&](std::string_view timing) { return m_timing_vals(timing); };
+      // Power (in mW) drawn from all rails with the given IDD
+      auto P = [&](std::string_view idd) {
+        return m_voltage_vals("VDD1") * m_current_vals(std::string(idd) + "_1") +
+               m_voltage_vals("VDD2") * m_current_vals(std::string(idd) + "_2");
+      };
+
+      double tCK_ns = (double) TS("tCK_ps") / 1000.0;
+
+      rank_stats.act_background_energy = P("IDD3N") * rank_stats.active_cycles * tCK_ns / 1E3;
+      rank_stats.pre_background_energy = P("IDD2N") * rank_stats.idle_cycles * tCK_ns / 1E3;
+      rank_stats.pd_background_energy  = P("IDD2P") * rank_stats.power_down_cycles * tCK_ns / 1E3;
+      rank_stats.sr_background_energy  = P("IDD6") * rank_stats.self_refresh_cycles * tCK_ns / 1E3;
+      rank_stats.wck_energy            = P("IWCK") * rank_stats.wck_cycles * tCK_ns / 1E3;
+
+      double act_cmd_energy = (P("IDD0") - P("IDD3N")) * rank_stats.cmd_counters[m_cmds_counted["ACT"]] * TS("nRAS") * tCK_ns / 1E3;
+      double pre_cmd_energy = (P("IDD0") - P("IDD2N")) * rank_stats.cmd_counters[m_cmds_counted["PRE"]] * TS("nRPpb") * tCK_ns / 1E3;
+      double rd_cmd_energy  = (P("IDD4R") - P("IDD3N")) * rank_stats.cmd_counters[m_cmds_counted["RD"]] * TS("nBL24") * tCK_ns / 1E3;
+      double wr_cmd_energy  = (P("IDD4W") - P("IDD3N")) * rank_stats.cmd_counters[m_cmds_counted["WR"]] * TS("nBL24") * tCK_ns / 1E3;
+      double ref_cmd_energy = (P("IDD5AB") - P("IDD3N")) * rank_stats.cmd_counters[m_cmds_counted["REFab"]] * TS("nRFCab") * tCK_ns / 1E3 +
+                              (P("IDD5PB") - P("IDD3N")) * rank_stats.cmd_counters[m_cmds_counted["REFpb"]] * TS("nRFCpb") * tCK_ns / 1E3;
+
+      rank_stats.total_background_energy = rank_stats.act_background_energy + rank_stats.pre_background_energy +
+                                            rank_stats.pd_background_energy + rank_stats.sr_background_energy + rank_stats.wck_energy;
+      rank_stats.total_cmd_energy = act_cmd_energy + pre_cmd_energy + rd_cmd_energy + wr_cmd_energy + ref_cmd_energy;
+      rank_stats.total_energy = rank_stats.total_background_energy + rank_stats.total_cmd_energy;
+
+      s_total_background_energy += rank_stats.total_background_energy;
+      s_total_cmd_energy += rank_stats.total_cmd_energy;
+      s_total_energy += rank_stats.total_energy;
+    };
 
     void create_nodes() {
       int num_channels = m_organization.count[m_levels["channel"]];
@@ -666,4 +1224,166 @@ class LPDDR6 : public IDRAM, public Implementation {
 };
 
 
+/************************************************
+ *     Node Actions, Preqs, Row Hits/Opens
+ ***********************************************/
+constexpr LPDDR6::FuncTable_t<ActionFuncPtr_t<LPDDR6::Node>> LPDDR6::m_actions = [] {
+  FuncTable_t<ActionFuncPtr_t<Node>> t;
+  // Rank Actions
+  t[m_levels["rank"]][m_commands["PREA"]] = Lambdas::Action::Rank::PREab<LPDDR6>;
+  t[m_levels["rank"]][m_commands["REFab"]] = Lambdas::Action::Rank::REFab<LPDDR6>;
+  t[m_levels["rank"]][m_commands["RFMab"]] = Lambdas::Action::Rank::REFab<LPDDR6>;
+  t[m_levels["rank"]][m_commands["REFab_end"]] = Lambdas::Action::Rank::REFab_end<LPDDR6>;
+  t[m_levels["rank"]][m_commands["PDE"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_state = m_states["Power-Down"];
+  };
+  t[m_levels["rank"]][m_commands["SRE"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_state = m_states["Self-Refresh"];
+  };
+  t[m_levels["rank"]][m_commands["PDX"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_state = m_states["PowerUp"];
+  };
+  t[m_levels["rank"]][m_commands["SRX"]] = t[m_levels["rank"]][m_commands["PDX"]];
+  // Bank actions
+  t[m_levels["bank"]][m_commands["ACT-1"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_state = m_states["Pre-Opened"];
+    node->m_row_state.set(target_id, m_states["Pre-Opened"]);
+  };
+  t[m_levels["bank"]][m_commands["ACT-2"]] = Lambdas::Action::Bank::ACT<LPDDR6>;
+  t[m_levels["bank"]][m_commands["PRE"]]   = Lambdas::Action::Bank::PRE<LPDDR6>;
+  // The bank is closed right away, and the timing constraints above account for the implicit precharge
+  t[m_levels["bank"]][m_commands["RD24A"]] = Lambdas::Action::Bank::PRE<LPDDR6>;
+  t[m_levels["bank"]][m_commands["WR24A"]] = Lambdas::Action::Bank::PRE<LPDDR6>;
+  // Applied to both banks of the refreshed pair
+  t[m_levels["bank"]][m_commands["REFpb"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_state = m_states["Refreshing"];
+  };
+  t[m_levels["bank"]][m_commands["RFMpb"]] = t[m_levels["bank"]][m_commands["REFpb"]];
+  t[m_levels["bank"]][m_commands["REFpb_end"]] = [] (Node* node, int cmd, int target_id, Clk_t clk) {
+    node->m_state = m_states["Closed"];
+  };
+  return t;
+}();
+
+constexpr LPDDR6::FuncTable_t<PreqFuncPtr_t<LPDDR6::Node>> LPDDR6::m_preqs = [] {
+  FuncTable_t<PreqFuncPtr_t<Node>> t;
+  // Rank Preqs
+  // A rank in power-down or self-refresh has to be woken up before anything else
+  t[m_levels["rank"]][m_commands["RD24"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+    return get_wakeup_command(node);
+  };
+  t[m_levels["rank"]][m_commands["WR24"]]  = t[m_levels["rank"]][m_commands["RD24"]];
+  t[m_levels["rank"]][m_commands["RD24A"]] = t[m_levels["rank"]][m_commands["RD24"]];
+  t[m_levels["rank"]][m_commands["WR24A"]] = t[m_levels["rank"]][m_commands["RD24"]];
+
+  t[m_levels["rank"]][m_commands["REFab"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+    if (int wakeup_cmd = get_wakeup_command(node); wakeup_cmd != -1) {
+      return wakeup_cmd;
+    }
+    return Lambdas::Preq::Rank::RequireAllBanksClosed<LPDDR6>(node, cmd, addr_vec, clk);
+  };
+  t[m_levels["rank"]][m_commands["RFMab"]] = t[m_levels["rank"]][m_commands["REFab"]];
+  // Only precharge power-down is modeled, so both entries need all banks closed
+  t[m_levels["rank"]][m_commands["PDE"]]   = t[m_levels["rank"]][m_commands["REFab"]];
+  t[m_levels["rank"]][m_commands["SRE"]]   = t[m_levels["rank"]][m_commands["REFab"]];
+
+  // The addressed bank of a per-bank refresh is closed first by its bank preq. An open partner bank is then
+  // closed with a PRE that get_preq_addr_vec() aims at the partner, so the other banks of the rank stay open.
+  // The refresh manager usually closes the partner beforehand, but it may be reopened in the meantime.
+  t[m_levels["rank"]][m_commands["REFpb"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+    if (int wakeup_cmd = get_wakeup_command(node); wakeup_cmd != -1) {
+      return wakeup_cmd;
+    }
+
+    int bank_state = node->m_child_nodes[addr_vec[m_levels["bankgroup"]]]->m_child_nodes[addr_vec[m_levels["bank"]]]->m_state;
+    if (bank_state == m_states["Pre-Opened"] || bank_state == m_states["Opened"]) {
+      return -1;
+    }
+
+    auto [partner_bg, partner_bank] = node->m_spec->get_refresh_partner(addr_vec[m_levels["bankgroup"]], addr_vec[m_levels["bank"]]);
+    switch (node->m_child_nodes[partner_bg]->m_child_nodes[partner_bank]->m_state) {
+      case m_states["Pre-Opened"]: return m_commands["PRE"];
+      case m_states["Opened"]:     return m_commands["PRE"];
+      default:                     return -1;
+    }
+  };
+  t[m_levels["rank"]][m_commands["RFMpb"]] = t[m_levels["rank"]][m_commands["REFpb"]];
+
+  // Bank Preqs
+  t[m_levels["bank"]][m_commands["RD24"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+    switch (node->m_state) {
+      case m_states["Closed"]: return m_commands["ACT-1"];
+      case m_states["Refreshing"]: return m_commands["ACT-1"];
+      case m_states["Pre-Opened"]: return m_commands["ACT-2"];
+      case m_states["Opened"]: {
+        if (node->m_row_state.contains(addr_vec[m_levels["row"]])) {
+          Node* rank = node->m_parent_node->m_parent_node;
+          if (!node->m_spec->m_wck_always_on && rank->m_final_synced_cycle < clk) {
+            return m_commands["CASRD"];
+          }
+          return cmd;
+        } else {
+          return m_commands["PRE"];
+        }
+      }    
+      default: {
+        spdlog::error("[Preq::Bank] Invalid bank state for an RD/WR command!");
+        std::exit(-1);      
+      } 
+    }
+  };
+  t[m_levels["bank"]][m_commands["WR24"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+    switch (node->m_state) {
+      case m_states["Closed"]: return m_commands["ACT-1"];
+      case m_states["Refreshing"]: return m_commands["ACT-1"];
+      case m_states["Pre-Opened"]: return m_commands["ACT-2"];
+      case m_states["Opened"]: {
+        if (node->m_row_state.contains(addr_vec[m_levels["row"]])) {
+          Node* rank = node->m_parent_node->m_parent_node;
+          if (!node->m_spec->m_wck_always_on && rank->m_final_synced_cycle < clk) {
+            return m_commands["CASWR"];
+          }
+          return cmd;
+        } else {
+          return m_commands["PRE"];
+        }
+      }    
+      default: {
+        spdlog::error("[Preq::Bank] Invalid bank state for an RD/WR command!");
+        std::exit(-1);      
+      } 
+    }
+  };
+  t[m_levels["bank"]][m_commands["RD24A"]] = t[m_levels["bank"]][m_commands["RD24"]];
+  t[m_levels["bank"]][m_commands["WR24A"]] = t[m_levels["bank"]][m_commands["WR24"]];
+
+  t[m_levels["bank"]][m_commands["REFpb"]] = [] (Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+    switch (node->m_state) {
+      case m_states["Pre-Opened"]: return m_commands["PRE"];
+      case m_states["Opened"]: return m_commands["PRE"];
+      default: return cmd;
+    }
+  };
+  t[m_levels["bank"]][m_commands["RFMpb"]] = t[m_levels["bank"]][m_commands["REFpb"]];
+  return t;
+}();
+
+constexpr LPDDR6::FuncTable_t<RowhitFuncPtr_t<LPDDR6::Node>> LPDDR6::m_rowhits = [] {
+  FuncTable_t<RowhitFuncPtr_t<Node>> t;
+  t[m_levels["bank"]][m_commands["RD24"]] = Lambdas::RowHit::Bank::RDWR<LPDDR6>;
+  t[m_levels["bank"]][m_commands["WR24"]] = Lambdas::RowHit::Bank::RDWR<LPDDR6>;
+  t[m_levels["bank"]][m_commands["RD24A"]] = Lambdas::RowHit::Bank::RDWR<LPDDR6>;
+  t[m_levels["bank"]][m_commands["WR24A"]] = Lambdas::RowHit::Bank::RDWR<LPDDR6>;
+  return t;
+}();
+
+constexpr LPDDR6::FuncTable_t<RowopenFuncPtr_t<LPDDR6::Node>> LPDDR6::m_rowopens = [] {
+  FuncTable_t<RowopenFuncPtr_t<Node>> t;
+  t[m_levels["bank"]][m_commands["RD24"]] = Lambdas::RowOpen::Bank::RDWR<LPDDR6>;
+  t[m_levels["bank"]][m_commands["WR24"]] = Lambdas::RowOpen::Bank::RDWR<LPDDR6>;
+  t[m_levels["bank"]][m_commands["RD24A"]] = Lambdas::RowOpen::Bank::RDWR<LPDDR6>;
+  t[m_levels["bank"]][m_commands["WR24A"]] = Lambdas::RowOpen::Bank::RDWR<LPDDR6>;
+  return t;
+}();
+
 }        // namespace Ramulator
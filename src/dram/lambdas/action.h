@@ -16,7 +16,7 @@ namespace Bank {
   template <class T>
   void ACT(typename T::Node* node, int cmd, int target_id, Clk_t clk) {
     node->m_state = T::m_states["Opened"];
-    node->m_row_state[target_id] = T::m_states["Opened"];
+    node->m_row_state.set(target_id, T::m_states["Opened"]);
   };
 
   template <class T>
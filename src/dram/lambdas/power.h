@@ -1,6 +1,8 @@
 #ifndef RAMULATOR_DRAM_LAMBDAS_POWER_H
 #define RAMULATOR_DRAM_LAMBDAS_POWER_H
 
+#include <algorithm>
+
 #include <spdlog/spdlog.h>
 
 namespace Ramulator {
@@ -11,7 +13,7 @@ namespace Bank {
   int get_flat_rank_id(typename T::Node* node) {
     int channel_id = -1;
     int rank_id = -1;
-    int num_ranks = node->m_spec->get_level_size("rank");
+    int num_ranks = node->m_spec->m_organization.count[T::m_levels["rank"]];
     if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 1) {
       auto rank_node = node->m_parent_node;
       auto channel_node = rank_node->m_parent_node;
@@ -79,7 +81,7 @@ namespace Bank {
 namespace Rank {
   template <class T>
   int get_flat_rank_id(typename T::Node* node) {
-    int num_ranks = node->m_spec->get_level_size("rank");
+    int num_ranks = node->m_spec->m_organization.count[T::m_levels["rank"]];
     auto channel_node = node->m_parent_node;
     int rank_id = node->m_node_id;
     int channel_id = channel_node->m_node_id;
@@ -93,46 +95,27 @@ namespace Rank {
     }
   }
 
+  /**
+   * @brief   Counts the banks of the rank that are in the given state.
+   * @details The banks of a rank are a contiguous range of the flat bank states, so this is a linear count instead of a tree walk.
+   */
+  template <class T>
+  int count_bank_states(typename T::Node* node, int state) {
+    const auto& store = *node->m_store;
+    int bank_level = T::m_levels["bank"];
+    int num_banks_per_rank = store.m_num_nodes[bank_level] / store.m_num_nodes[node->m_level];
+    const int* bank_states = &store.m_states[bank_level][node->m_flat_id * num_banks_per_rank];
+    return std::count(bank_states, bank_states + num_banks_per_rank, state);
+  }
+
   template <class T>
   int get_open_bank_count(typename T::Node* node) {
-    int bank_count = 0;
-    if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 1) {
-      for (auto bank: node->m_child_nodes) {
-        if (bank->m_state == T::m_states["Opened"]) {
-          bank_count++;
-        }
-      }
-    } else if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 2) {
-      for (auto bg : node->m_child_nodes) {
-        for (auto bank: bg->m_child_nodes) {
-          if (bank->m_state == T::m_states["Opened"]) {
-              bank_count++;
-          }
-        }
-      }
-    }
-    return bank_count;
+    return count_bank_states<T>(node, T::m_states["Opened"]);
   }
 
   template <class T>
   int get_refreshing_bank_count(typename T::Node* node) {
-    int bank_count = 0;
-    if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 1) {
-      for (auto bank: node->m_child_nodes) {
-        if (bank->m_state == T::m_states["Refreshing"]) {
-          bank_count++;
-        }
-      }
-    } else if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 2) {
-      for (auto bg : node->m_child_nodes) {
-        for (auto bank: bg->m_child_nodes) {
-          if (bank->m_state == T::m_states["Refreshing"]) {
-              bank_count++;
-          }
-        }
-      }
-    }
-    return bank_count;
+    return count_bank_states<T>(node, T::m_states["Refreshing"]);
   }
 
   template <class T>
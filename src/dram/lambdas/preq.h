@@ -12,7 +12,7 @@ int RequireRowOpen(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, C
   switch (node->m_state) {
     case T::m_states["Closed"]: return T::m_commands["ACT"];
     case T::m_states["Opened"]: {
-      if (node->m_row_state.find(addr_vec[T::m_levels["row"]]) != node->m_row_state.end()) {
+      if (node->m_row_state.contains(addr_vec[T::m_levels["row"]])) {
         return cmd;
       } else {
         return T::m_commands["PRE"];
@@ -11,15 +11,15 @@ namespace Bank {
   bool RDWR(typename T::Node* node, int cmd, int target_id, Clk_t clk) {
     switch (node->m_state)  {
       case T::m_states["Closed"]: return false;
-      case T::m_states["Opened"]:
-        if (node->m_row_state.find(target_id) != node->m_row_state.end()) {
-          return true;
-        }
-        else {
-          return false;
-        }
+      case T::m_states["Opened"]: return node->m_row_state.contains(target_id);
       case T::m_states["Refreshing"]: return false;
       default: {
+        if constexpr (T::m_states.contains("Pre-Opened")) {
+          // The row is already latched by the first half of a two-step ACT (e.g., LPDDR5/6 ACT-1)
+          if (node->m_state == T::m_states["Pre-Opened"]) {
+            return node->m_row_state.contains(target_id);
+          }
+        }
         spdlog::error("[RowHit::Bank] Invalid bank state for an RD/WR command!");
         std::exit(-1);      
       }
@@ -14,6 +14,12 @@ namespace Bank {
       case T::m_states["Opened"]: return true;
       case T::m_states["Refreshing"]: return false;
       default: {
+        if constexpr (T::m_states.contains("Pre-Opened")) {
+          // The row is already latched by the first half of a two-step ACT (e.g., LPDDR5/6 ACT-1)
+          if (node->m_state == T::m_states["Pre-Opened"]) {
+            return true;
+          }
+        }
         spdlog::error("[RowHit::Bank] Invalid bank state for an RD/WR command!");
         std::exit(-1);      
       }
@@ -3,9 +3,12 @@
 
 #include <vector>
 #include <map>
-#include <deque>
 #include <functional>
 #include <concepts>
+#include <memory>
+#include <array>
+#include <optional>
+#include <type_traits>
 
 #include "base/type.h"
 #include "dram/spec.h"
@@ -26,6 +29,275 @@ concept IsDRAMSpec = requires(T t) {
 // };
 
 
+/**
+ * @brief     Set of the open rows of a bank-ish node
+ * @details
+ * A bank usually has at most one open row, so the first N open rows are kept inline and looked up
+ * with a linear scan. Only specs that genuinely keep more rows open than that spill into a map.
+ *
+ */
+template<int N>
+class OpenRowSlots {
+  public:
+    using RowId_t = int;
+    using RowState_t = int;
+
+  private:
+    int m_num_inline = 0;
+    RowId_t m_rows[N];
+    RowState_t m_states[N];
+    std::map<RowId_t, RowState_t> m_overflow;
+
+  public:
+    /**
+     * @brief    Returns the state of the row, or nullptr if the row is not open.
+     */
+    const RowState_t* find(RowId_t row) const {
+      for (int i = 0; i < m_num_inline; i++) {
+        if (m_rows[i] == row) {
+          return &m_states[i];
+        }
+      }
+      if (!m_overflow.empty()) {
+        auto it = m_overflow.find(row);
+        if (it != m_overflow.end()) {
+          return &it->second;
+        }
+      }
+      return nullptr;
+    };
+
+    bool contains(RowId_t row) const { return find(row) != nullptr; };
+
+    void set(RowId_t row, RowState_t state) {
+      for (int i = 0; i < m_num_inline; i++) {
+        if (m_rows[i] == row) {
+          m_states[i] = state;
+          return;
+        }
+      }
+      if (m_num_inline < N) {
+        m_rows[m_num_inline] = row;
+        m_states[m_num_inline] = state;
+        m_num_inline++;
+      } else {
+        m_overflow[row] = state;
+      }
+    };
+
+    void clear() {
+      m_num_inline = 0;
+      m_overflow.clear();
+    };
+
+    bool empty() const { return m_num_inline == 0; };
+    size_t size() const { return m_num_inline + m_overflow.size(); };
+};
+
+/**
+ * @brief     Number of open rows kept inline per bank. Specs can override it with a static m_max_open_rows.
+ */
+template<typename T>
+constexpr int open_row_capacity() {
+  if constexpr (requires { T::m_max_open_rows; }) {
+    return T::m_max_open_rows;
+  } else {
+    return 1;
+  }
+}
+
+
+/**
+ * @brief     Issue-history of all commands of a node
+ * @details
+ * The history of each command is a fixed-size ring buffer whose size is the largest timing window
+ * of the command (e.g., 4 for nFAW). All rings of a node are stored back to back in one array.
+ *
+ */
+class CommandHistory {
+  private:
+    std::vector<Clk_t> m_clks;    // The ring buffers of all commands
+    std::vector<int> m_offsets;   // Offset of the ring of each command in m_clks
+    std::vector<int> m_windows;   // Size of the ring of each command (0: not tracked)
+    std::vector<int> m_heads;     // Slot of the most recent issue of each command
+
+  public:
+    void init(const std::vector<int>& windows) {
+      m_windows = windows;
+      m_offsets.resize(windows.size());
+      m_heads.assign(windows.size(), 0);
+      int size = 0;
+      for (int cmd = 0; cmd < windows.size(); cmd++) {
+        m_offsets[cmd] = size;
+        size += windows[cmd];
+      }
+      m_clks.assign(size, -1);
+    };
+
+    bool is_tracked(int command) const { return m_windows[command] != 0; };
+
+    void push(int command, Clk_t clk) {
+      int head = m_heads[command] == 0 ? m_windows[command] - 1 : m_heads[command] - 1;
+      m_heads[command] = head;
+      m_clks[m_offsets[command] + head] = clk;
+    };
+
+    /**
+     * @brief    Returns the clock of the (age+1)-th most recent issue of the command, or -1 if there is none.
+     */
+    Clk_t get(int command, int age) const {
+      int slot = m_heads[command] + age;
+      if (slot >= m_windows[command]) {
+        slot -= m_windows[command];
+      }
+      return m_clks[m_offsets[command] + slot];
+    };
+};
+
+
+/**
+ * @brief     Flat per-level storage of the hot node data of one channel
+ * @details
+ * Every node of the hierarchy gets a flat id at its level (e.g., the flat id of a bank is
+ * ((rank * #bankgroups) + bankgroup) * #banks + bank). The states and the command ready clocks
+ * of all nodes at the same level are stored contiguously and indexed by the flat id.
+ * The nodes keep references into this storage so the lambdas can still access them as members.
+ *
+ * On top of the per-node ready clocks, the store maintains for every node and command the latest
+ * ready clock along the path from the channel down to the node. It is updated incrementally when a
+ * ready clock increases, so the earliest cycle a command can be issued to its target is a single
+ * load. The descendants of a node at any level are a contiguous range of flat ids, so the update
+ * is a few linear sweeps.
+ *
+ */
+template<IsDRAMSpec T>
+struct DRAMNodeStore {
+    int m_num_cmds = -1;
+    int m_last_level = -1;                            // The lowest level that has nodes (e.g., bank)
+    std::vector<int> m_level_sizes;                   // Number of children of each node at every level
+    std::vector<int> m_num_nodes;                     // Number of nodes at every level
+    std::vector<int> m_cmd_scopes;                    // Scope of each command, capped at m_last_level
+    std::vector<std::vector<int>> m_states;           // [level][flat_id]
+    std::vector<std::vector<Clk_t>> m_ready_clk;      // [level][flat_id * m_num_cmds + command]
+    std::vector<std::vector<Clk_t>> m_path_ready_clk; // [level][command * m_num_nodes[level] + flat_id]
+
+    DRAMNodeStore(T* spec) {
+      static_assert(T::m_levels.size() <= AddrVec_t::capacity(), "The address vector cannot hold all levels of the DRAM organization!");
+      m_num_cmds = T::m_commands.size();
+      m_level_sizes = spec->m_organization.count;
+
+      int num_nodes = 1;    // The root (i.e., channel) level only has this channel
+      int row_level = T::m_levels["row"];
+      for (int level = 0; level < row_level; level++) {
+        if (level > 0) {
+          if (m_level_sizes[level] == 0) {
+            break;
+          }
+          num_nodes *= m_level_sizes[level];
+        }
+        m_num_nodes.push_back(num_nodes);
+        m_states.emplace_back(num_nodes, spec->m_init_states[level]);
+        m_ready_clk.emplace_back(num_nodes * m_num_cmds, -1);
+        m_path_ready_clk.emplace_back(num_nodes * m_num_cmds, -1);
+        m_last_level = level;
+      }
+
+      for (int cmd = 0; cmd < m_num_cmds; cmd++) {
+        m_cmd_scopes.push_back(std::min<int>(spec->m_command_scopes[cmd], m_last_level));
+      }
+    };
+
+    /**
+     * @brief    Raises the ready clock of a command at a node and propagates it to the path summaries below.
+     */
+    void update_ready_clk(int level, int flat_id, int command, Clk_t clk) {
+      Clk_t& ready_clk = m_ready_clk[level][flat_id * m_num_cmds + command];
+      if (clk <= ready_clk) {
+        return;
+      }
+      ready_clk = clk;
+
+      // Levels below the scope of the command are never checked
+      int begin = flat_id;
+      int end = flat_id + 1;
+      for (int l = level; l <= m_cmd_scopes[command]; l++) {
+        if (l > level) {
+          begin *= m_level_sizes[l];
+          end *= m_level_sizes[l];
+        }
+        Clk_t* path_ready_clk = &m_path_ready_clk[l][command * m_num_nodes[l]];
+        for (int i = begin; i < end; i++) {
+          path_ready_clk[i] = std::max(path_ready_clk[i], clk);
+        }
+      }
+    };
+
+    /**
+     * @brief    Returns the earliest cycle the timing constraints allow the command to the address below the given node.
+     */
+    Clk_t get_ready_clk(int level, int flat_id, int command, const AddrVec_t& addr_vec) const {
+      int scope = m_cmd_scopes[command];
+      while (level < scope) {
+        level++;
+        int child_id = addr_vec[level];
+        if (child_id == -1) {
+          // if it is a same bank command, wait for all children
+          Clk_t ready_clk = -1;
+          for (int i = 0; i < m_level_sizes[level]; i++) {
+            ready_clk = std::max(ready_clk, get_ready_clk(level, flat_id * m_level_sizes[level] + i, command, addr_vec));
+          }
+          return ready_clk;
+        }
+        flat_id = flat_id * m_level_sizes[level] + child_id;
+      }
+      return m_path_ready_clk[level][command * m_num_nodes[level] + flat_id];
+    };
+};
+
+
+/**
+ * @brief     Compile-time [level][command] table of device lambdas
+ * @details
+ * Opt-in replacement of FuncMatrix. A spec defines it constexpr once the spec is complete, so the table
+ * is one contiguous array of function pointers at a fixed address: the node indexes it directly instead of
+ * loading it from the spec and calling through a std::function. The lambdas must be captureless; they can
+ * reach the device through node->m_spec instead of capturing this.
+ * 
+ */
+template<typename F, int NumLevels, int NumCmds>
+struct FuncTable {
+    using Func_t = F;
+    static constexpr int num_cmds = NumCmds;
+
+    std::array<F, NumLevels * NumCmds> m_funcs{};
+
+    constexpr F* operator[](int level) { return &m_funcs[level * NumCmds]; };
+    constexpr const F* operator[](int level) const { return &m_funcs[level * NumCmds]; };
+};
+
+template<typename F>
+struct FuncResult;
+template<typename R, typename... Args>
+struct FuncResult<R (*)(Args...)> { using type = R; };
+template<typename R, typename... Args>
+struct FuncResult<std::function<R(Args...)>> { using type = R; };
+
+/**
+ * @brief    Calls the function if it is set. Returns whether it is set (void) or its result (std::optional).
+ */
+template<typename R, typename F, typename... Args>
+auto call_if_set(const F& func, const Args&... args) {
+  if constexpr (std::is_void_v<R>) {
+    if (!func) {
+      return false;
+    }
+    func(args...);
+    return true;
+  } else {
+    return func ? std::optional<R>(func(args...)) : std::nullopt;
+  }
+}
+
 /**
  * @brief     CRTP-ish (?) base class of a DRAM Device Node
  * 
@@ -42,33 +314,35 @@ struct DRAMNodeBase {
     int m_node_id = -1;    // The id of this node at this level
     int m_size = -1;       // The size of the node (e.g., how many rows in a bank)
 
-    int m_state = -1;      // The state of the node
+    std::shared_ptr<DRAMNodeStore<T>> m_store;      // The flat storage shared by all nodes of the channel
+    int m_flat_id = -1;                             // The flat id of this node at this level
 
-    std::vector<Clk_t> m_cmd_ready_clk;             // The next cycle that each command can be issued again at this level
-    std::vector<std::deque<Clk_t>> m_cmd_history;   // Issue-history of each command at this level
+    int& m_state;                                   // The state of the node
+    int64_t m_state_epoch = 0;                      // Number of state changes of this node
+    int64_t m_subtree_epoch = 0;                    // Number of state changes of this node and the nodes below it
+    const Clk_t* m_cmd_ready_clk;                   // The next cycle that each command can be issued again at this level
+    CommandHistory m_cmd_history;                   // Issue-history of each command at this level
 
     using RowId_t = int;
     using RowState_t = int;
-    std::map<RowId_t, RowState_t> m_row_state;  // The state of the rows, if I am a bank-ish node
+    OpenRowSlots<open_row_capacity<T>()> m_row_state;   // The state of the open rows, if I am a bank-ish node
 
     DRAMNodeBase(T* spec, NodeType* parent, int level, int id):
-    m_spec(spec), m_parent_node(parent), m_level(level), m_node_id(id) {
+    m_parent_node(parent), m_spec(spec), m_level(level), m_node_id(id),
+    m_store(parent ? parent->m_store : std::make_shared<DRAMNodeStore<T>>(spec)),
+    m_flat_id(parent ? parent->m_flat_id * spec->m_organization.count[level] + id : 0),
+    m_state(m_store->m_states[level][m_flat_id]),
+    m_cmd_ready_clk(&m_store->m_ready_clk[level][m_flat_id * m_store->m_num_cmds]) {
+      // The entries of each command are sorted by window, so the last one has the longest history
       int num_cmds = T::m_commands.size();
-      m_cmd_ready_clk.resize(num_cmds, -1);
-      m_cmd_history.resize(num_cmds);
+      const TimingConsTable& target_cons = spec->m_timing_table.target[level];
+      std::vector<int> windows(num_cmds, 0);
       for (int cmd = 0; cmd < num_cmds; cmd++) {
-        int window = 0;
-        for (const auto& t : spec->m_timing_cons[level][cmd]) {
-          window = std::max(window, t.window);
-        }
-        if (window != 0) {
-          m_cmd_history[cmd].resize(window, -1);
-        } else {
-          m_cmd_history[cmd].clear();
+        if (target_cons.begin(cmd) != target_cons.end(cmd)) {
+          windows[cmd] = target_cons.windows[target_cons.end(cmd) - 1];
         }
       }
-
-      m_state = spec->m_init_states[m_level];
+      m_cmd_history.init(windows);
 
       // Recursively construct next levels
       int next_level = level + 1;
@@ -88,11 +362,28 @@ struct DRAMNodeBase {
       }
     };
 
+    /**
+     * @brief    Calls the lambda of the command at this level from the given table of the spec, if there is one.
+     * @details  table_ptr points either to a static constexpr FuncTable or to a FuncMatrix member of the spec.
+     */
+    template<auto table_ptr, typename... Args>
+    auto call_func(int command, const Args&... args) {
+      const auto& func = [this, command]() -> const auto& {
+        if constexpr (std::is_member_object_pointer_v<decltype(table_ptr)>) {
+          return (m_spec->*table_ptr)[m_level][command];
+        } else {
+          return (*table_ptr)[m_level][command];
+        }
+      }();
+      using R = typename FuncResult<std::remove_cvref_t<decltype(func)>>::type;
+      return call_if_set<R>(func, args...);
+    };
+
     void update_states(int command, const AddrVec_t& addr_vec, Clk_t clk) {
       int child_id = addr_vec[m_level+1];
-      if (m_spec->m_actions[m_level][command]) {
-        // update the state machine at this level
-        m_spec->m_actions[m_level][command](static_cast<NodeType*>(this), command, child_id, clk); 
+      if (call_func<&T::m_actions>(command, static_cast<NodeType*>(this), command, child_id, clk)) {
+        // updated the state machine at this level
+        bump_state_epoch();
       }
       if (m_level == m_spec->m_command_scopes[command] || !m_child_nodes.size()) {
         // stop recursion: updated all levels
@@ -113,10 +404,8 @@ struct DRAMNodeBase {
         return;
 
       int child_id = addr_vec[m_level+1];
-      if (m_spec->m_powers[m_level][command]) {
-        // update the power model at this level
-        m_spec->m_powers[m_level][command](static_cast<NodeType*>(this), command, addr_vec, clk);
-      }
+      // update the power model at this level
+      call_func<&T::m_powers>(command, static_cast<NodeType*>(this), command, addr_vec, clk);
       if (m_level == m_spec->m_command_scopes[command] || !m_child_nodes.size()) {
         // stop recursion: updated all levels
         return; 
@@ -136,15 +425,11 @@ struct DRAMNodeBase {
        *         Update Sibling Node Timing
        ***********************************************/
       if (m_node_id != addr_vec[m_level] && addr_vec[m_level] != -1) {
-        for (const auto& t : m_spec->m_timing_cons[m_level][command]) {
-          if (!t.sibling) {
-            // not sibling timing parameter
-            continue; 
-          }
-
+        const TimingConsTable& sibling_cons = m_spec->m_timing_table.sibling[m_level];
+        for (int i = sibling_cons.begin(command); i < sibling_cons.end(command); i++) {
           // update earliest schedulable time of every command
-          Clk_t future = clk + t.val;
-          m_cmd_ready_clk[t.cmd] = std::max(m_cmd_ready_clk[t.cmd], future); 
+          Clk_t future = clk + sibling_cons.vals[i];
+          m_store->update_ready_clk(m_level, m_flat_id, sibling_cons.cmds[i], future);
         }
         // stop recursion
         return;
@@ -154,26 +439,27 @@ struct DRAMNodeBase {
        *          Update Target Node Timing
        ***********************************************/
       // Update history
-      if (m_cmd_history[command].size()) {
-        m_cmd_history[command].pop_back();
-        m_cmd_history[command].push_front(clk); 
+      if (m_cmd_history.is_tracked(command)) {
+        m_cmd_history.push(command, clk);
       }
 
-      for (const auto& t : m_spec->m_timing_cons[m_level][command]) {
-        if (t.sibling) {
-          continue; 
-        }
-
-        // Get the oldest history
-        Clk_t past = m_cmd_history[command][t.window-1];
-        if (past < 0) {
-          // not enough history
-          continue; 
+      const TimingConsTable& target_cons = m_spec->m_timing_table.target[m_level];
+      int window = 0;
+      Clk_t past = -1;
+      for (int i = target_cons.begin(command); i < target_cons.end(command); i++) {
+        if (target_cons.windows[i] != window) {
+          // Get the oldest history (entries are sorted by window)
+          window = target_cons.windows[i];
+          past = m_cmd_history.get(command, window-1);
+          if (past < 0) {
+            // not enough history, and neither for the longer windows
+            break; 
+          }
         }
 
         // update earliest schedulable time of every command
-        Clk_t future = past + t.val;
-        m_cmd_ready_clk[t.cmd] = std::max(m_cmd_ready_clk[t.cmd], future);
+        Clk_t future = past + target_cons.vals[i];
+        m_store->update_ready_clk(m_level, m_flat_id, target_cons.cmds[i], future);
       }
 
       if (!m_child_nodes.size()) {
@@ -189,11 +475,10 @@ struct DRAMNodeBase {
 
     int get_preq_command(int command, const AddrVec_t& addr_vec, Clk_t m_clk) {
       int child_id = addr_vec[m_level + 1];
-      if (m_spec->m_preqs[m_level][command]) {
-        int preq_cmd = m_spec->m_preqs[m_level][command](static_cast<NodeType*>(this), command, addr_vec, m_clk);
-        if (preq_cmd != -1) {
+      if (auto preq_cmd = call_func<&T::m_preqs>(command, static_cast<NodeType*>(this), command, addr_vec, m_clk)) {
+        if (*preq_cmd != -1) {
           // stop recursion: there is a prerequisite at this level
-          return preq_cmd; 
+          return *preq_cmd; 
         }
       }
 
@@ -206,37 +491,44 @@ struct DRAMNodeBase {
       return m_child_nodes[child_id]->get_preq_command(command, addr_vec, m_clk);
     };
 
-    bool check_ready(int command, const AddrVec_t& addr_vec, Clk_t clk) {
-      if (m_cmd_ready_clk[command] != -1 && clk < m_cmd_ready_clk[command]) {
-        // stop recursion: the check failed at this level
-        return false; 
+    /**
+     * @brief    Records a state change of this node (e.g., by an action).
+     */
+    void bump_state_epoch() {
+      m_state_epoch++;
+      for (DRAMNodeBase* node = this; node != nullptr; node = node->m_parent_node) {
+        node->m_subtree_epoch++;
       }
+    };
 
-      int child_id = addr_vec[m_level+1];
-      if (m_level == m_spec->m_command_scopes[command] || !m_child_nodes.size()) {
-        // stop recursion: the check passed at all levels
-        return true; 
+    /**
+     * @brief    Returns the state epoch of the address.
+     * @details
+     * Sums the state epochs of the nodes above the addressed node and the subtree epoch of the addressed
+     * node itself (e.g., a rank-level REFab depends on the states of all banks of the rank). An action only
+     * changes the node it runs at and the nodes below it, so the sum changes whenever any of these does.
+     */
+    int64_t get_state_epoch(const AddrVec_t& addr_vec) {
+      if (!m_child_nodes.size() || addr_vec[m_level + 1] == -1) {
+        return m_subtree_epoch;
       }
+      return m_state_epoch + m_child_nodes[addr_vec[m_level + 1]]->get_state_epoch(addr_vec);
+    };
 
-      if (child_id == -1) {
-        // if it is a same bank command, recurse all children in rank level
-        bool ready = true;
-        for (auto child : m_child_nodes) {
-          ready = ready && child->check_ready(command, addr_vec, clk);
-        }
-        return ready;
-      } else {
-        // recursively check my child
-        return m_child_nodes[child_id]->check_ready(command, addr_vec, clk);
-      }
+    bool check_ready(int command, const AddrVec_t& addr_vec, Clk_t clk) {
+      return clk >= m_store->get_ready_clk(m_level, m_flat_id, command, addr_vec);
+    };
+
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) {
+      return m_store->get_ready_clk(m_level, m_flat_id, command, addr_vec);
     };
 
     bool check_rowbuffer_hit(int command, const AddrVec_t& addr_vec, Clk_t m_clk) {
       // TODO: Optimize this by just checking the bank-levels? Have a dedicated bank structure?
       int child_id = addr_vec[m_level+1];
-      if (m_spec->m_rowhits[m_level][command]) {
+      if (auto hit = call_func<&T::m_rowhits>(command, static_cast<NodeType*>(this), command, child_id, m_clk)) {
         // stop recursion: there is a row hit at this level
-        return m_spec->m_rowhits[m_level][command](static_cast<NodeType*>(this), command, child_id, m_clk);  
+        return *hit;  
       }
 
       if (!m_child_nodes.size()) {
@@ -251,9 +543,9 @@ struct DRAMNodeBase {
     bool check_node_open(int command, const AddrVec_t& addr_vec, Clk_t m_clk) {
 
       int child_id = addr_vec[m_level+1];
-      if (m_spec->m_rowopens[m_level][command])
+      if (auto open = call_func<&T::m_rowopens>(command, static_cast<NodeType*>(this), command, child_id, m_clk))
         // stop recursion: there is a row open at this level
-        return m_spec->m_rowopens[m_level][command](static_cast<NodeType*>(this), command, child_id, m_clk);  
+        return *open;  
 
       if (!m_child_nodes.size())
         // stop recursion: there were no row hits at any level
@@ -278,6 +570,17 @@ using PowerFunc_t = std::function<void(typename T::Node* node, int cmd, const Ad
 template<typename T>
 using FuncMatrix = std::vector<std::vector<T>>;
 
+template<class T>
+using ActionFuncPtr_t  = void (*)(typename T::Node* node, int cmd, int target_id, Clk_t clk);
+template<class T>
+using PreqFuncPtr_t    = int  (*)(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk);
+template<class T>
+using RowhitFuncPtr_t  = bool (*)(typename T::Node* node, int cmd, int target_id, Clk_t clk);
+template<class T>
+using RowopenFuncPtr_t = bool (*)(typename T::Node* node, int cmd, int target_id, Clk_t clk);
+template<class T>
+using PowerFuncPtr_t   = void (*)(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk);
+
 // TODO: Enable easy syntax for FuncMatrix lookup
 // template<typename T, int N, int M>
 // class FuncMatrix : public std::array<std::array<T, M>, N> {
@@ -7,6 +7,7 @@
 #include <map>
 #include <array>
 #include <ranges>
+#include <algorithm>
 #include <stdexcept>
 
 #include <spdlog/spdlog.h>
@@ -65,6 +66,69 @@ struct TimingConsEntry {
 
 using TimingCons = std::vector<std::vector<std::vector<TimingConsEntry>>>;
 
+/**
+ * @brief     Dense form of the timing constraints of one level and one kind (sibling or not)
+ * @details
+ * The constraints of all preceding commands are stored back to back as a structure of arrays.
+ * The constraints of command c are [offsets[c], offsets[c+1]). Duplicated {preceding, following, window}
+ * entries are merged into the one with the largest value, and the entries of each command are sorted
+ * by window so that the node looks up the issue history only once per distinct window.
+ *
+ */
+struct TimingConsTable {
+  std::vector<int> offsets;   // [preceding command], plus the end of the last command
+  std::vector<int> cmds;      // The following command
+  std::vector<int> vals;      // The value of the timing constraint
+  std::vector<int> windows;   // How many issues of the preceding command back the constraint is counted from
+
+  int begin(int command) const { return offsets[command]; };
+  int end(int command) const { return offsets[command + 1]; };
+};
+
+struct CompiledTimingCons {
+  std::vector<TimingConsTable> sibling;   // [level] Constraints on the siblings of the target node
+  std::vector<TimingConsTable> target;    // [level] Constraints on the target node itself
+};
+
+inline CompiledTimingCons compile_timingcons(const TimingCons& timing_cons) {
+  CompiledTimingCons compiled;
+  for (const auto& level_cons : timing_cons) {
+    TimingConsTable& sibling = compiled.sibling.emplace_back();
+    TimingConsTable& target = compiled.target.emplace_back();
+    for (const auto& cmd_cons : level_cons) {
+      sibling.offsets.push_back(sibling.cmds.size());
+      target.offsets.push_back(target.cmds.size());
+
+      // {window, following command} -> largest value. Windows do not matter for siblings.
+      std::map<std::pair<int, int>, int> sibling_vals;
+      std::map<std::pair<int, int>, int> target_vals;
+      for (const auto& t : cmd_cons) {
+        if (t.sibling) {
+          auto [it, inserted] = sibling_vals.try_emplace({1, t.cmd}, t.val);
+          it->second = std::max(it->second, t.val);
+        } else if (t.window > 0) {
+          auto [it, inserted] = target_vals.try_emplace({t.window, t.cmd}, t.val);
+          it->second = std::max(it->second, t.val);
+        }
+      }
+
+      for (const auto& [key, val] : sibling_vals) {
+        sibling.cmds.push_back(key.second);
+        sibling.vals.push_back(val);
+        sibling.windows.push_back(key.first);
+      }
+      for (const auto& [key, val] : target_vals) {
+        target.cmds.push_back(key.second);
+        target.vals.push_back(val);
+        target.windows.push_back(key.first);
+      }
+    }
+    sibling.offsets.push_back(sibling.cmds.size());
+    target.offsets.push_back(target.cmds.size());
+  }
+  return compiled;
+};
+
 // // TODO: Write a expression parser and evaluator
 // template<class T>
 // int EvalTimingExpr(T* spec, std::string_view expr) {
@@ -95,6 +159,7 @@ void populate_timingcons(T* spec, std::vector<TimingConsInitializer> initializer
       }
     }
   }
+  spec->m_timing_table = compile_timingcons(spec->m_timing_cons);
 };
 
 
@@ -164,6 +229,14 @@ class ImplDef : public std::array<std::string_view, N> {
       }
       throw "NON EXISTENT NAME";
     };
+    consteval bool contains(std::string_view name) const {
+      for (int i = 0; i < N; i++) {
+        if (std::array<std::string_view, N>::operator[](i) == name) {
+          return true;
+        } 
+      }
+      return false;
+    };
 
     constexpr std::string_view operator()(int i) const {
       if (i < N) {
@@ -300,12 +373,16 @@ struct PowerStats {
     enum class PowerState {
       IDLE = 0,
       ACTIVE = 1,
-      REFRESHING = 2
+      REFRESHING = 2,
+      POWER_DOWN = 3,
+      SELF_REFRESH = 4
     };
     PowerState cur_power_state = PowerState::IDLE;
 
     double act_background_energy = 0;
     double pre_background_energy = 0;
+    double pd_background_energy = 0;
+    double sr_background_energy = 0;
 
     double total_background_energy = 0;
     double total_cmd_energy = 0;
@@ -315,9 +392,18 @@ struct PowerStats {
 
     Clk_t active_cycles = 0;
     Clk_t idle_cycles = 0;
+    Clk_t power_down_cycles = 0;
+    Clk_t self_refresh_cycles = 0;
 
     Clk_t active_start_cycle = -1; // initially rank is not active
     Clk_t idle_start_cycle = 0;
+
+    Clk_t wck_cycles = 0;           // Cycles the WCK is toggling, for models with a WCK clock
+    Clk_t wck_synced_cycle = -1;    // Last cycle covered by wck_cycles so far
+    double wck_energy = 0;
+
+    uint64_t active_bank_mask = 0;  // Banks (flat id in the rank) that are not precharged, for models that track them per rank
+    Clk_t state_start_cycle = 0;    // Start of cur_power_state, for models that track all states with one timestamp
     
 };        
 
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <filesystem>
+
+#include "base/exception.h"
+#include "dram/vcd_tracer.h"
+
+namespace Ramulator {
+
+namespace fs = std::filesystem;
+
+void VCDTracer::configure(const Config& config, int clk_period_ps) {
+  m_config = config;
+  m_clk_period_ps = clk_period_ps;
+  m_enabled = true;
+
+  size_t capacity = 1;
+  while (capacity < std::max<size_t>(m_config.buffer_size, 2)) {
+    capacity <<= 1;
+  }
+  m_ring.resize(capacity);
+  m_ring_mask = capacity - 1;
+  // Wake up the writer whenever a quarter of the ring has been filled
+  m_wakeup_batch = std::max<size_t>(capacity / 4, 1);
+
+  fs::create_directories(m_config.path);
+}
+
+int VCDTracer::add_signal(std::string_view group, std::string_view scope, std::string_view name, int width) {
+  if (!m_enabled) {
+    return -1;
+  }
+
+  if (std::find(m_groups.begin(), m_groups.end(), group) == m_groups.end()) {
+    m_groups.emplace_back(group);
+  }
+  if (!m_config.signals.empty() &&
+      std::find(m_config.signals.begin(), m_config.signals.end(), group) == m_config.signals.end()) {
+    return -1;
+  }
+
+  m_signals.push_back({std::string(scope), std::string(name), width});
+  return m_signals.size() - 1;
+}
+
+void VCDTracer::write_translation_table(std::string_view filename, const std::vector<std::string_view>& names, int width) {
+  if (!m_enabled) {
+    return;
+  }
+
+  fs::path table_path = fs::path(m_config.path) / filename;
+  FILE* table = fopen(table_path.c_str(), "w");
+  if (table == nullptr) {
+    throw ConfigurationError("Cannot open VCD translation table {}!", table_path.string());
+  }
+  for (size_t i = 0; i < names.size(); i++) {
+    fprintf(table, "%s %s\n", std::bitset<64>(i).to_string().substr(64 - width).c_str(), std::string(names[i]).c_str());
+  }
+  fclose(table);
+}
+
+void VCDTracer::start() {
+  if (!m_enabled) {
+    return;
+  }
+
+  for (const auto& group : m_config.signals) {
+    if (std::find(m_groups.begin(), m_groups.end(), group) == m_groups.end()) {
+      throw ConfigurationError("Unknown VCD signal group \"{}\"!", group);
+    }
+  }
+
+  fs::path vcd_path = fs::path(m_config.path) / "trace.vcd";
+  m_file = fopen(vcd_path.c_str(), "w");
+  if (m_file == nullptr) {
+    throw ConfigurationError("Cannot open VCD file {}!", vcd_path.string());
+  }
+  write_header();
+
+  m_writer = std::thread(&VCDTracer::writer_loop, this);
+}
+
+void VCDTracer::close() {
+  if (!m_enabled) {
+    return;
+  }
+  m_enabled = false;
+
+  if (m_writer.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_data_cv.notify_one();
+    m_writer.join();
+  }
+
+  if (m_file) {
+    drain();
+    fclose(m_file);
+    m_file = nullptr;
+  }
+}
+
+void VCDTracer::wait_for_space(size_t head) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_data_cv.notify_one();
+  m_space_cv.wait(lock, [this, head] { return head - m_tail.load(std::memory_order_acquire) <= m_ring_mask; });
+}
+
+void VCDTracer::writer_loop() {
+  while (true) {
+    bool stop = false;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      // Time out periodically in case a wake-up is missed by the lock-free producer
+      m_data_cv.wait_for(lock, std::chrono::milliseconds(10), [this] {
+        return m_stop || m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed) >= m_wakeup_batch;
+      });
+      stop = m_stop;
+    }
+
+    drain();
+    {
+      // Synchronize with a producer that is about to wait for free space
+      std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_space_cv.notify_one();
+
+    if (stop) {
+      return;
+    }
+  }
+}
+
+void VCDTracer::drain() {
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  size_t head = m_head.load(std::memory_order_acquire);
+  if (tail == head) {
+    return;
+  }
+
+  std::string buffer;
+  buffer.reserve((head - tail) * 24);
+  char bits[65];
+  for (; tail != head; tail++) {
+    const Record& record = m_ring[tail & m_ring_mask];
+    if (record.clk != m_last_written_clk) {
+      buffer += '#';
+      buffer += std::to_string(record.clk * m_clk_period_ps);
+      buffer += '\n';
+      m_last_written_clk = record.clk;
+    }
+
+    // VCD left-extends vector values with zeros, so only the significant bits are written
+    const Signal& signal = m_signals[record.signal_id];
+    int num_bits = 0;
+    uint64_t value = record.value;
+    do {
+      bits[64 - (++num_bits)] = '0' + (value & 1);
+      value >>= 1;
+    } while (value != 0 && num_bits < signal.width);
+    buffer += 'b';
+    buffer.append(bits + 64 - num_bits, num_bits);
+    buffer += ' ';
+    buffer += signal.name;
+    buffer += '\n';
+  }
+  m_tail.store(tail, std::memory_order_release);
+
+  fwrite(buffer.data(), 1, buffer.size(), m_file);
+}
+
+void VCDTracer::write_header() {
+  fprintf(m_file, "$timescale 1ps $end\n");
+
+  // Open and close the nested scopes as the signals walk through the hierarchy
+  std::vector<std::string> cur_scopes;
+  for (const auto& signal : m_signals) {
+    std::vector<std::string> scopes;
+    for (size_t begin = 0, end = 0; end != std::string::npos; begin = end + 1) {
+      end = signal.scope.find('.', begin);
+      scopes.push_back(signal.scope.substr(begin, end - begin));
+    }
+
+    size_t num_common = 0;
+    while (num_common < cur_scopes.size() && num_common < scopes.size() && cur_scopes[num_common] == scopes[num_common]) {
+      num_common++;
+    }
+    for (size_t i = cur_scopes.size(); i > num_common; i--) {
+      fprintf(m_file, "$upscope $end\n");
+    }
+    for (size_t i = num_common; i < scopes.size(); i++) {
+      fprintf(m_file, "$scope module %s $end\n", scopes[i].c_str());
+    }
+    cur_scopes = scopes;
+
+    fprintf(m_file, "$var wire %d %s %s $end\n", signal.width, signal.name.c_str(), signal.name.c_str());
+  }
+  for (size_t i = 0; i < cur_scopes.size(); i++) {
+    fprintf(m_file, "$upscope $end\n");
+  }
+
+  fprintf(m_file, "$enddefinitions $end\n");
+}
+
+}        // namespace Ramulator
@@ -0,0 +1,138 @@
+#ifndef RAMULATOR_DRAM_VCD_TRACER_H
+#define RAMULATOR_DRAM_VCD_TRACER_H
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief     Asynchronous VCD waveform tracer for DRAM device models
+ * @details
+ * The device model registers its signals once and then only pushes fixed-size binary records
+ * (cycle, signal, value) into a single-producer ring buffer on its hot path. A background writer
+ * thread drains the ring, formats the records into VCD text, and writes them out. When the tracer
+ * is not enabled, record() is never reached because callers guard on is_enabled().
+ *
+ * Signals are grouped (e.g., "cmd", "bank_status") so that a run can trace only a subset of them,
+ * and records outside of the [start_clk, end_clk] window are dropped before entering the ring.
+ *
+ */
+class VCDTracer {
+  public:
+    struct Config {
+      std::string path = "trace";           // Output directory of the VCD file and the value translation tables
+      Clk_t start_clk = 0;                  // First cycle to trace
+      Clk_t end_clk = -1;                   // Last cycle to trace (-1: until the end of the simulation)
+      std::vector<std::string> signals;     // Signal groups to trace (empty: all groups)
+      size_t buffer_size = 1 << 16;         // Number of records in the ring buffer (rounded up to a power of two)
+    };
+
+  private:
+    struct Record {
+      Clk_t clk;
+      uint64_t value;
+      int signal_id;
+    };
+
+    struct Signal {
+      std::string scope;    // Dot-separated scope path (e.g., "ramulator.cmd")
+      std::string name;     // Name (also used as the VCD identifier)
+      int width;
+    };
+
+    Config m_config;
+    bool m_enabled = false;
+    int m_clk_period_ps = 1;
+
+    std::vector<Signal> m_signals;
+    std::vector<std::string> m_groups;    // All signal groups offered by the device, traced or not
+
+    // Ring buffer shared by the simulation thread (producer) and the writer thread (consumer)
+    std::vector<Record> m_ring;
+    size_t m_ring_mask = 0;
+    size_t m_wakeup_batch = 0;
+    std::atomic<size_t> m_head = 0;   // Next slot to be written by the producer
+    std::atomic<size_t> m_tail = 0;   // Next slot to be read by the consumer
+
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_data_cv;
+    std::condition_variable m_space_cv;
+    bool m_stop = false;
+
+    FILE* m_file = nullptr;
+    Clk_t m_last_written_clk = -1;
+
+  public:
+    VCDTracer() = default;
+    VCDTracer(const VCDTracer&) = delete;
+    VCDTracer& operator=(const VCDTracer&) = delete;
+    ~VCDTracer() { close(); };
+
+    /**
+     * @brief    Enables the tracer with the given configuration. Signals can be added afterwards until start() is called.
+     */
+    void configure(const Config& config, int clk_period_ps);
+
+    /**
+     * @brief    Registers a signal. Returns its id, or -1 if the tracer is disabled or the signal group is filtered out.
+     */
+    int add_signal(std::string_view group, std::string_view scope, std::string_view name, int width);
+
+    /**
+     * @brief    Writes a value translation table (e.g., command encodings) next to the VCD file for the waveform viewer.
+     */
+    void write_translation_table(std::string_view filename, const std::vector<std::string_view>& names, int width);
+
+    /**
+     * @brief    Writes the VCD header and launches the writer thread.
+     */
+    void start();
+
+    /**
+     * @brief    Drains all outstanding records, stops the writer thread, and closes the file.
+     */
+    void close();
+
+    bool is_enabled() const { return m_enabled; };
+
+    bool is_in_window(Clk_t clk) const {
+      return clk >= m_config.start_clk && (m_config.end_clk < 0 || clk <= m_config.end_clk);
+    };
+
+    void record(Clk_t clk, int signal_id, uint64_t value) {
+      if (signal_id < 0 || !is_in_window(clk)) {
+        return;
+      }
+
+      size_t head = m_head.load(std::memory_order_relaxed);
+      if (head - m_tail.load(std::memory_order_acquire) > m_ring_mask) {
+        wait_for_space(head);
+      }
+      m_ring[head & m_ring_mask] = {clk, value, signal_id};
+      m_head.store(head + 1, std::memory_order_release);
+
+      if (((head + 1) & (m_wakeup_batch - 1)) == 0) {
+        m_data_cv.notify_one();
+      }
+    };
+
+  private:
+    void wait_for_space(size_t head);
+    void writer_loop();
+    void drain();
+    void write_header();
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_DRAM_VCD_TRACER_H
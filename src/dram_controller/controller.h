@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <deque>
+#include <limits>
+#include <unordered_map>
 
 #include <spdlog/spdlog.h>
 #include <yaml-cpp/yaml.h>
@@ -17,6 +19,88 @@
 
 namespace Ramulator {
 
+/**
+ * @brief    Counts the read/write requests queued in a controller at every node down to the bank, and per row.
+ * @details
+ * The controller adds a request when it enters one of its queues and removes it when it leaves them, so
+ * get_num_queued_requests() does not have to scan the queues. Nodes are numbered per level within the
+ * channel of the controller (e.g., the second bank of rank 1 with 16 banks per rank is bank 17).
+ *
+ */
+class QueuedRequestCounts {
+  private:
+    int m_bank_level = -1;
+    int m_row_level = -1;
+    std::vector<int> m_level_sizes;
+    int64_t m_num_rows = 0;
+
+    size_t m_num_reqs = 0;
+    std::vector<std::vector<size_t>> m_node_counts;     // Number of queued requests at each node of the levels above the row
+    std::unordered_map<int64_t, size_t> m_row_counts;   // Number of queued requests to each row (by bank * #rows + row)
+
+  public:
+    void setup(IDRAM* dram) {
+      m_bank_level = dram->m_levels("bank");
+      m_row_level = dram->m_levels("row");
+      m_level_sizes = dram->m_organization.count;
+      m_num_rows = m_level_sizes[m_row_level];
+
+      m_node_counts.resize(m_bank_level + 1);
+      int num_nodes = 1;
+      for (int level = 1; level <= m_bank_level; level++) {
+        num_nodes *= m_level_sizes[level];
+        m_node_counts[level].assign(num_nodes, 0);
+      }
+    };
+
+    void add(const Request& req) { update(req.addr_vec, 1); };
+    void remove(const Request& req) { update(req.addr_vec, -1); };
+
+    /**
+     * @brief    Returns the number of queued requests to the given address.
+     * @details  The address has to give every level down to some level above the column, and -1 below it.
+     */
+    size_t get(const AddrVec_t& addr_vec) const {
+      int node_id = 0;
+      for (int level = 1; level <= m_bank_level; level++) {
+        if (addr_vec[level] == -1) {
+          check_unspecified(addr_vec, level);
+          return level == 1 ? m_num_reqs : m_node_counts[level - 1][node_id];
+        }
+        node_id = node_id * m_level_sizes[level] + addr_vec[level];
+      }
+      if (addr_vec[m_row_level] == -1) {
+        check_unspecified(addr_vec, m_row_level);
+        return m_node_counts[m_bank_level][node_id];
+      }
+      check_unspecified(addr_vec, m_row_level + 1);
+      auto it = m_row_counts.find(node_id * m_num_rows + addr_vec[m_row_level]);
+      return it == m_row_counts.end() ? 0 : it->second;
+    };
+
+  private:
+    void update(const AddrVec_t& addr_vec, int delta) {
+      m_num_reqs += delta;
+      int node_id = 0;
+      for (int level = 1; level <= m_bank_level; level++) {
+        node_id = node_id * m_level_sizes[level] + addr_vec[level];
+        m_node_counts[level][node_id] += delta;
+      }
+      int64_t row_id = node_id * m_num_rows + addr_vec[m_row_level];
+      if ((m_row_counts[row_id] += delta) == 0) {
+        m_row_counts.erase(row_id);
+      }
+    };
+
+    void check_unspecified(const AddrVec_t& addr_vec, int from_level) const {
+      for (int level = from_level; level < addr_vec.size(); level++) {
+        if (addr_vec[level] != -1) {
+          throw std::runtime_error("Queued requests can only be counted down to a level (with -1 for all levels below it)!");
+        }
+      }
+    };
+};
+
 class IDRAMController : public Clocked<IDRAMController> {
   RAMULATOR_REGISTER_INTERFACE(IDRAMController, "Controller", "Memory Controller Interface");
 
@@ -49,6 +133,32 @@ class IDRAMController : public Clocked<IDRAMController> {
      * 
      */
     virtual void tick() = 0;
+
+    /**
+     * @brief       Returns the earliest cycle at which ticking the controller can change its state (assuming no new requests).
+     * 
+     */
+    virtual Clk_t get_next_event_clk() { return m_clk + 1; };
+
+    /**
+     * @brief       Advances the clock to the given cycle, which must be before get_next_event_clk().
+     * 
+     */
+    virtual void fast_forward(Clk_t clk) {};
+
+    /**
+     * @brief       Returns the number of queued read/write requests to the given address.
+     * @details     Levels set to -1 in the address match any node (e.g., {channel, rank, -1, ...} counts the requests to a rank).
+     *              Only the levels below the last given one can be -1 (see QueuedRequestCounts).
+     * 
+     */
+    virtual size_t get_num_queued_requests(const AddrVec_t& addr_vec) = 0;
+
+    /**
+     * @brief       Returns how many more high-priority requests priority_send() can accept right now.
+     * 
+     */
+    virtual size_t get_priority_buffer_room() { return std::numeric_limits<size_t>::max(); };
    
 };
 
@@ -21,6 +21,7 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
     ReqBuffer m_priority_buffer;          // Buffer for high-priority requests (e.g., maintenance like refresh).
     ReqBuffer m_read_buffer;              // Read request buffer
     ReqBuffer m_write_buffer;             // Write request buffer
+    QueuedRequestCounts m_queued_reqs;    // Number of requests in the active, read and write buffers
 
     int m_rank_addr_idx = -1;
     int m_bankgroup_addr_idx = -1;
@@ -69,6 +70,7 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
       m_bank_addr_idx = m_dram->m_levels("bank");
       m_row_addr_idx = m_dram->m_levels("row");
       m_priority_buffer.max_size = 512*3 + 32;
+      m_queued_reqs.setup(m_dram);
       
       int num_cores = static_cast<BHO3*>(frontend)->get_num_cores();
       s_core_row_hits.resize(num_cores);
@@ -120,6 +122,7 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
         return false;
       }
 
+      m_queued_reqs.add(req);
       return true;
     };
 
@@ -131,6 +134,14 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
       return is_success;
     }
 
+    size_t get_priority_buffer_room() override {
+      return m_priority_buffer.max_size - m_priority_buffer.size();
+    };
+
+    size_t get_num_queued_requests(const AddrVec_t& addr_vec) override {
+      return m_queued_reqs.get(addr_vec);
+    };
+
     void tick() override {
       m_clk++;
       // 1. Serve completed reads
@@ -147,6 +158,9 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
       // 2.1 RowPolicy
       m_rowpolicy->update(request_found, req_it);
 
+      // 2.2 Refresh manager
+      m_refresh->update(request_found, req_it);
+
       // 3. Update all plugins
       for (auto plugin : m_plugins) {
         plugin->update(request_found, req_it);
@@ -155,10 +169,13 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
       // 4. Finally, issue the commands to serve the request
       if (request_found) {
         // If we find a real request to serve
-        m_dram->issue_command(req_it->command, req_it->addr_vec);
+        m_dram->issue_command(req_it->command, m_dram->get_preq_addr_vec(req_it->final_command, req_it->command, req_it->addr_vec));
 
         // If we are issuing the last command, set depart clock cycle and move the request to the pending queue
         if (req_it->command == req_it->final_command) {
+          if (buffer != &m_priority_buffer) {
+            m_queued_reqs.remove(*req_it);
+          }
           if (req_it->type_id == Request::Type::Read) {
             req_it->depart = m_clk + m_dram->m_read_latency;
             pending.push_back(*req_it);
@@ -169,6 +186,9 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
         } else {
           if (m_dram->m_command_meta(req_it->command).is_opening) {
             if (m_active_buffer.enqueue(*req_it)) {
+              if (buffer == &m_priority_buffer) {
+                m_queued_reqs.add(*req_it);
+              }
               buffer->remove(req_it);
             }
           }
@@ -242,9 +262,9 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
         if (m_priority_buffer.size() != 0) {
           req_buffer = &m_priority_buffer;
           req_it = m_priority_buffer.begin();
-          req_it->command = m_dram->get_preq_command(req_it->final_command, req_it->addr_vec);
+          m_dram->update_preq_command(*req_it);
           
-          request_found = m_dram->check_ready(req_it->command, req_it->addr_vec);
+          request_found = m_dram->check_ready(req_it->command, m_dram->get_preq_addr_vec(req_it->final_command, req_it->command, req_it->addr_vec));
           if (!request_found & m_priority_buffer.size() != 0) {
             return false;
           }
@@ -264,7 +284,7 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
 
       if (request_found) {
         if (m_dram->m_command_meta(req_it->command).is_closing) {
-          auto& rowgroup = req_it->addr_vec;
+          AddrVec_t rowgroup = m_dram->get_preq_addr_vec(req_it->final_command, req_it->command, req_it->addr_vec);
           for (auto _it = m_active_buffer.begin(); _it != m_active_buffer.end(); _it++) {
             auto& _it_rowgroup = _it->addr_vec;
             bool is_matching = true;
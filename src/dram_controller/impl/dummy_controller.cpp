@@ -28,6 +28,11 @@ class DummyController final : public IDRAMController, public Implementation {
       return;
     }
 
+    size_t get_num_queued_requests(const AddrVec_t& addr_vec) override {
+      // Requests are served as soon as they are sent, so none is ever queued
+      return 0;
+    };
+
 };
 
 }   // namespace Ramulator
\ No newline at end of file
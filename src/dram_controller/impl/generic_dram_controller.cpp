@@ -6,12 +6,16 @@ namespace Ramulator {
 class GenericDRAMController final : public IDRAMController, public Implementation {
   RAMULATOR_REGISTER_IMPLEMENTATION(IDRAMController, GenericDRAMController, "Generic", "A generic DRAM controller.");
   private:
-    std::deque<Request> pending;          // A queue for read requests that are about to finish (callback after RL)
+    ReqPool m_req_pool;                   // Slots of all requests in the controller, moved between the buffers by index
 
-    ReqBuffer m_active_buffer;            // Buffer for requests being served. This has the highest priority 
-    ReqBuffer m_priority_buffer;          // Buffer for high-priority requests (e.g., maintenance like refresh).
-    ReqBuffer m_read_buffer;              // Read request buffer
-    ReqBuffer m_write_buffer;             // Write request buffer
+    ReqBuffer pending{&m_req_pool};       // A queue for read requests that are about to finish (callback after RL)
+
+    ReqBuffer m_active_buffer{&m_req_pool};   // Buffer for requests being served. This has the highest priority 
+    ReqBuffer m_priority_buffer{&m_req_pool}; // Buffer for high-priority requests (e.g., maintenance like refresh).
+    ReqBuffer m_read_buffer{&m_req_pool};     // Read request buffer
+    ReqBuffer m_write_buffer{&m_req_pool};    // Write request buffer
+    std::unordered_map<Addr_t, int> m_write_addrs;  // Number of queued writes to each address (for forwarding)
+    QueuedRequestCounts m_queued_reqs;        // Number of requests in the active, read and write buffers
 
     int m_bank_addr_idx = -1;
 
@@ -54,6 +58,18 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
     void init() override {
       m_wr_low_watermark =  param<float>("wr_low_watermark").desc("Threshold for switching back to read mode.").default_val(0.2f);
       m_wr_high_watermark = param<float>("wr_high_watermark").desc("Threshold for switching to write mode.").default_val(0.8f);
+      if (m_wr_low_watermark > m_wr_high_watermark) {
+        throw ConfigurationError("wr_low_watermark ({}) must not be larger than wr_high_watermark ({})!", m_wr_low_watermark, m_wr_high_watermark);
+      }
+
+      int read_queue_size = param<int>("read_queue_size").desc("Number of entries in the read request queue.").default_val(32);
+      int write_queue_size = param<int>("write_queue_size").desc("Number of entries in the write request queue.").default_val(32);
+      if (read_queue_size < 1 || write_queue_size < 1) {
+        throw ConfigurationError("The read ({}) and write ({}) queue sizes must be at least 1!", read_queue_size, write_queue_size);
+      }
+      m_read_buffer.max_size = read_queue_size;
+      m_write_buffer.max_size = write_queue_size;
+      pending.max_size = std::numeric_limits<size_t>::max();
 
       m_scheduler = create_child_ifce<IScheduler>();
       m_refresh = create_child_ifce<IRefreshManager>();    
@@ -66,15 +82,18 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
         }
       }
 
-      m_logger = Logging::create_logger("testlog");
-      m_read_buffer.max_size = 1;
-      m_write_buffer.max_size = 1;
+      // The controllers of all channels write to the same log
+      m_logger = spdlog::get("Ramulator::testlog");
+      if (!m_logger) {
+        m_logger = Logging::create_logger("testlog");
+      }
     };
 
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
       m_dram = memory_system->get_ifce<IDRAM>();
       m_bank_addr_idx = m_dram->m_levels("bank");
       m_priority_buffer.max_size = 512*3 + 32;
+      m_queued_reqs.setup(m_dram);
 
       m_num_cores = frontend->get_num_cores();
 
@@ -134,14 +153,10 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
 
       // Forward existing write requests to incoming read requests
       if (req.type_id == Request::Type::Read) {
-        auto compare_addr = [req](const Request& wreq) {
-          return wreq.addr == req.addr;
-        };
-        if (std::find_if(m_write_buffer.begin(), m_write_buffer.end(), compare_addr) != m_write_buffer.end()) {
+        if (m_write_addrs.contains(req.addr)) {
           // The request will depart at the next cycle
           req.depart = m_clk + 1;
-          pending.push_back(req);
-          return true;
+          return pending.enqueue(req);
         }
       }
 
@@ -161,6 +176,10 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
         return false;
       }
 
+      if (req.type_id == Request::Type::Write) {
+        m_write_addrs[req.addr]++;
+      }
+      m_queued_reqs.add(req);
       return true;
     };
 
@@ -186,14 +205,20 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
 
       m_refresh->tick();
 
-      // 2. Try to find a request to serve.
+      // 2. Try to find a request to serve, unless the command bus is still busy with the last command
       ReqBuffer::iterator req_it;
       ReqBuffer* buffer = nullptr;
-      bool request_found = schedule_request(req_it, buffer);
+      bool request_found = false;
+      if (m_dram->get_command_bus_ready_clk(m_channel_id) <= m_clk) {
+        request_found = schedule_request(req_it, buffer);
+      }
 
       // 2.1 Take row policy action
       m_rowpolicy->update(request_found, req_it);
 
+      // 2.2 Let the refresh manager track the issued refreshes
+      m_refresh->update(request_found, req_it);
+
       // 3. Update all plugins
       for (auto plugin : m_plugins) {
         plugin->update(request_found, req_it);
@@ -205,34 +230,81 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
         if (req_it->is_stat_updated == false) {
           update_request_stats(req_it);
         }
-        m_dram->issue_command(req_it->command, req_it->addr_vec);
+        m_dram->issue_command(req_it->command, m_dram->get_preq_addr_vec(req_it->final_command, req_it->command, req_it->addr_vec));
         m_logger->info("Issuing command {} for request addr {} at clk {}", 
                        m_dram->m_commands(req_it->command), req_it->addr, m_clk);
 
         // If we are issuing the last command, set depart clock cycle and move the request to the pending queue
         if (req_it->command == req_it->final_command) {
+          if (buffer != &m_priority_buffer) {
+            m_queued_reqs.remove(*req_it);
+          }
           if (req_it->type_id == Request::Type::Read) {
             req_it->depart = m_clk + m_dram->m_read_latency;
-            pending.push_back(*req_it);
-          } else if (req_it->type_id == Request::Type::Write) {
-            // TODO: Add code to update statistics
+            buffer->transfer(req_it, pending);
+          } else {
+            if (req_it->type_id == Request::Type::Write) {
+              // TODO: Add code to update statistics
+              if (auto it = m_write_addrs.find(req_it->addr); --it->second == 0) {
+                m_write_addrs.erase(it);
+              }
+            }
+            buffer->remove(req_it);
           }
-          buffer->remove(req_it);
         } else {
           if (m_dram->m_command_meta(req_it->command).is_opening) {
-            if (m_active_buffer.enqueue(*req_it)) {
-              buffer->remove(req_it);
+            if (buffer->transfer(req_it, m_active_buffer) && buffer == &m_priority_buffer) {
+              m_queued_reqs.add(*req_it);
             }
           }
         }
 
-      }else{
-        // 使用NOP占位
-        if(m_clk % 2 == 0){
-          m_dram->issue_command(m_dram->m_commands("NOP"), AddrVec_t(m_dram->m_levels.size(), 0));
-        }
       }
+    };
+
+    Clk_t get_next_event_clk() override {
+      if (m_active_buffer.size() || m_priority_buffer.size() || m_read_buffer.size() || m_write_buffer.size()) {
+        return m_clk + 1;
+      }
+
+      // With empty buffers, only a completing read, a refresh, or a row policy/plugin action can change anything
+      Clk_t next_clk = m_refresh->get_next_event_clk(m_clk);
+      if (pending.size()) {
+        next_clk = std::min(next_clk, std::max(pending.begin()->depart, m_clk + 1));
+      }
+      next_clk = std::min(next_clk, m_rowpolicy->get_next_event_clk(m_clk));
+      for (auto plugin : m_plugins) {
+        next_clk = std::min(next_clk, plugin->get_next_event_clk(m_clk));
+      }
+      return next_clk;
+    };
+
+    void fast_forward(Clk_t clk) override {
+      Clk_t cycles = clk - m_clk;
+      if (cycles <= 0) {
+        return;
+      }
+
+      // Account for the statistics that would have been collected in the skipped ticks
+      s_queue_len += cycles * pending.size();
+      s_read_queue_len += cycles * pending.size();
+
+      // An idle tick switches to write mode when there are no reads (idempotent afterwards)
+      set_write_mode();
+
+      m_clk = clk;
+      m_refresh->fast_forward(clk);
+      for (auto plugin : m_plugins) {
+        plugin->fast_forward(clk);
+      }
+    };
+
+    size_t get_priority_buffer_room() override {
+      return m_priority_buffer.max_size - m_priority_buffer.size();
+    };
 
+    size_t get_num_queued_requests(const AddrVec_t& addr_vec) override {
+      return m_queued_reqs.get(addr_vec);
     };
 
 
@@ -309,7 +381,8 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
     void serve_completed_reads() {
       if (pending.size()) {
         // Check the first pending request
-        auto& req = pending[0];
+        auto req_it = pending.begin();
+        auto& req = *req_it;
         if (req.depart <= m_clk) {
           // Request received data from dram
           if (req.depart - req.arrive > 1) {
@@ -325,7 +398,7 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
             req.callback(req);
           }
           // Finally, remove this request from the pending queue
-          pending.pop_front();
+          pending.remove(req_it);
         }
       };
     };
@@ -368,9 +441,9 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
         if (m_priority_buffer.size() != 0) {
           req_buffer = &m_priority_buffer;
           req_it = m_priority_buffer.begin();
-          req_it->command = m_dram->get_preq_command(req_it->final_command, req_it->addr_vec);
+          m_dram->update_preq_command(*req_it);
           
-          request_found = m_dram->check_ready(req_it->command, req_it->addr_vec);
+          request_found = m_dram->check_ready(req_it->command, m_dram->get_preq_addr_vec(req_it->final_command, req_it->command, req_it->addr_vec));
           if (!request_found & m_priority_buffer.size() != 0) {
             return false;
           }
@@ -391,7 +464,7 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
       // 2.3 If we find a request to schedule, we need to check if it will close an opened row in the active buffer.
       if (request_found) {
         if (m_dram->m_command_meta(req_it->command).is_closing) {
-          auto& rowgroup = req_it->addr_vec;
+          AddrVec_t rowgroup = m_dram->get_preq_addr_vec(req_it->final_command, req_it->command, req_it->addr_vec);
           for (auto _it = m_active_buffer.begin(); _it != m_active_buffer.end(); _it++) {
             auto& _it_rowgroup = _it->addr_vec;
             bool is_matching = true;
@@ -368,7 +368,7 @@ class Hydra : public IControllerPlugin, public Implementation {
               }
               // generate write request to DRAM for rct
               for (int i = 0; i < m_group_rct_cl_size; i++){
-                std::vector<int> rct_init_addr_vec;
+                AddrVec_t rct_init_addr_vec;
                 for (int j = 0; j < req_it->addr_vec.size(); j++){
                   rct_init_addr_vec.push_back(req_it->addr_vec[j]);
                 }
@@ -415,7 +415,7 @@ class Hydra : public IControllerPlugin, public Implementation {
                   std::cout << "Hydra: RCC full, evicting " << tag_to_evict << std::endl;
                 }
                 // generate write request to DRAM for evicted entry
-                std::vector<int> evicted_entry_addr_vec;
+                AddrVec_t evicted_entry_addr_vec;
                 for (int i = 0; i < req_it->addr_vec.size(); i++){
                   evicted_entry_addr_vec.push_back(req_it->addr_vec[i]);
                 }
@@ -0,0 +1,195 @@
+#include <vector>
+#include <limits>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/plugin.h"
+
+namespace Ramulator {
+
+/**
+ * @brief     Idle-driven power-down manager
+ * @details
+ * Puts a rank into power-down once no data command (i.e., an opening or accessing command) has been
+ * issued to it for pd_threshold cycles, and further into self-refresh after sr_threshold idle cycles.
+ * The entries are sent as high-priority requests. Waking the rank up is left to the device: a command
+ * to a sleeping rank has the exit command (e.g., PDX/SRX) as its prerequisite, so ranks wake up on demand
+ * and pay the exit latency. A rank with read/write requests queued in the controller (which every
+ * controller counts, see IDRAMController::get_num_queued_requests()) is not put to sleep.
+ *
+ */
+class IdlePowerDown : public IControllerPlugin, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IControllerPlugin, IdlePowerDown, "IdlePowerDown", "Puts idle ranks into power-down and self-refresh.")
+
+  private:
+    enum class RankState {
+      Awake,
+      PowerDownPending,     // The entry request is queued in the controller
+      PowerDown,
+      SelfRefreshPending,
+      SelfRefresh,
+    };
+
+    IDRAM* m_dram = nullptr;
+
+    Clk_t m_clk = 0;
+
+    Clk_t m_pd_threshold = -1;
+    Clk_t m_sr_threshold = -1;
+
+    int m_pd_req_id = -1;
+    int m_sr_req_id = -1;
+    int m_pde_cmd = -1;
+    int m_sre_cmd = -1;
+
+    int m_rank_level = -1;
+    int m_num_ranks = -1;
+
+    std::vector<AddrVec_t> m_rank_addr_vecs;
+    std::vector<RankState> m_rank_states;
+    std::vector<Clk_t> m_last_active_clk;   // The last cycle a data command was issued to each rank
+    std::vector<Clk_t> m_last_wakeup_clk;   // The last cycle each rank was woken up
+
+    size_t s_num_power_downs = 0;
+    size_t s_num_self_refreshes = 0;
+    size_t s_num_wakeups = 0;
+
+  public:
+    void init() override {
+      m_pd_threshold = param<Clk_t>("pd_threshold").desc("Number of idle cycles before a rank enters power-down (-1 to disable).").default_val(64);
+      m_sr_threshold = param<Clk_t>("sr_threshold").desc("Number of idle cycles before a rank enters self-refresh (-1 to disable).").default_val(-1);
+      if (m_pd_threshold >= 0 && m_sr_threshold >= 0 && m_sr_threshold <= m_pd_threshold) {
+        throw ConfigurationError("sr_threshold ({}) must be larger than pd_threshold ({})!", m_sr_threshold, m_pd_threshold);
+      }
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_ctrl = cast_parent<IDRAMController>();
+      m_dram = m_ctrl->m_dram;
+
+      for (auto req_name : {"power-down", "self-refresh"}) {
+        if (!m_dram->m_requests.contains(req_name)) {
+          throw ConfigurationError("DRAM standard {} does not support request: {}!", m_dram->get_name(), req_name);
+        }
+      }
+      m_pd_req_id = m_dram->m_requests("power-down");
+      m_sr_req_id = m_dram->m_requests("self-refresh");
+      m_pde_cmd = m_dram->m_request_translations(m_pd_req_id);
+      m_sre_cmd = m_dram->m_request_translations(m_sr_req_id);
+
+      m_rank_level = m_dram->m_levels("rank");
+      m_num_ranks = m_dram->get_level_size("rank");
+      for (int rank = 0; rank < m_num_ranks; rank++) {
+        AddrVec_t addr_vec(m_dram->m_levels.size(), -1);
+        addr_vec[0] = m_ctrl->m_channel_id;
+        addr_vec[m_rank_level] = rank;
+        m_rank_addr_vecs.push_back(addr_vec);
+      }
+      m_rank_states.resize(m_num_ranks, RankState::Awake);
+      m_last_active_clk.resize(m_num_ranks, 0);
+      m_last_wakeup_clk.resize(m_num_ranks, 0);
+
+      register_stat(s_num_power_downs).name("num_power_downs_{}", m_ctrl->m_channel_id);
+      register_stat(s_num_self_refreshes).name("num_self_refreshes_{}", m_ctrl->m_channel_id);
+      register_stat(s_num_wakeups).name("num_wakeups_{}", m_ctrl->m_channel_id);
+    };
+
+    void update(bool request_found, ReqBuffer::iterator& req_it) override {
+      m_clk++;
+
+      if (request_found) {
+        record_command(req_it->command, req_it->addr_vec);
+      }
+
+      for (int rank = 0; rank < m_num_ranks; rank++) {
+        Clk_t entry_clk = get_entry_clk(rank);
+        if (entry_clk >= 0 && m_clk >= entry_clk) {
+          if (has_queued_requests(rank)) {
+            // E.g., a request that has just woken up the rank is still waiting for the exit latency
+            m_last_active_clk[rank] = m_clk;
+          } else if (m_rank_states[rank] == RankState::Awake && m_pd_threshold >= 0) {
+            enter(rank, m_pd_req_id, RankState::PowerDownPending);
+          } else {
+            enter(rank, m_sr_req_id, RankState::SelfRefreshPending);
+          }
+        }
+      }
+    };
+
+    Clk_t get_next_event_clk(Clk_t clk) override {
+      Clk_t next_clk = std::numeric_limits<Clk_t>::max();
+      for (int rank = 0; rank < m_num_ranks; rank++) {
+        if (Clk_t entry_clk = get_entry_clk(rank); entry_clk >= 0) {
+          next_clk = std::min(next_clk, entry_clk);
+        }
+      }
+      return std::max(next_clk, clk + 1);
+    };
+
+    void fast_forward(Clk_t clk) override {
+      m_clk = clk;
+    };
+
+  private:
+    /**
+     * @brief    Returns the cycle at which the rank should enter its next sleep state, or -1 if it should not.
+     * @details
+     * A rank that was just woken up (e.g., to serve a request or a refresh) stays awake for at least
+     * one threshold, so that the command that woke it up gets issued first.
+     */
+    Clk_t get_entry_clk(int rank) {
+      switch (m_rank_states[rank]) {
+        case RankState::Awake: {
+          Clk_t threshold = m_pd_threshold >= 0 ? m_pd_threshold : m_sr_threshold;
+          return threshold >= 0 ? std::max(m_last_active_clk[rank], m_last_wakeup_clk[rank]) + threshold : -1;
+        }
+        case RankState::PowerDown: {
+          return m_sr_threshold >= 0 ? m_last_active_clk[rank] + m_sr_threshold : -1;
+        }
+        default: return -1;
+      }
+    };
+
+    void record_command(int command, const AddrVec_t& addr_vec) {
+      int rank = addr_vec[m_rank_level];
+      if (rank < 0) {
+        return;
+      }
+
+      if (command == m_pde_cmd) {
+        m_rank_states[rank] = RankState::PowerDown;
+        s_num_power_downs++;
+        return;
+      } else if (command == m_sre_cmd) {
+        m_rank_states[rank] = RankState::SelfRefresh;
+        s_num_self_refreshes++;
+        return;
+      }
+
+      // Any other command to a sleeping rank must have woken it up
+      if (m_rank_states[rank] == RankState::PowerDown || m_rank_states[rank] == RankState::SelfRefresh) {
+        m_rank_states[rank] = RankState::Awake;
+        m_last_wakeup_clk[rank] = m_clk;
+        s_num_wakeups++;
+      }
+
+      // Maintenance (e.g., refresh, wake-ups) does not count as activity
+      const auto& meta = m_dram->m_command_meta(command);
+      if (meta.is_opening || meta.is_accessing) {
+        m_last_active_clk[rank] = m_clk;
+      }
+    };
+
+    bool has_queued_requests(int rank) {
+      return m_ctrl->get_num_queued_requests(m_rank_addr_vecs[rank]) > 0;
+    };
+
+    void enter(int rank, int req_id, RankState pending_state) {
+      Request req(m_rank_addr_vecs[rank], req_id);
+      if (m_ctrl->priority_send(req)) {
+        m_rank_states[rank] = pending_state;
+      }
+    };
+};
+
+}       // namespace Ramulator
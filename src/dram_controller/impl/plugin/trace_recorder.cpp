@@ -51,7 +51,7 @@ class TraceRecorder : public IControllerPlugin, public Implementation {
           "{}, {}, {}", 
           m_clk,
           m_dram->m_commands(req_it->command),
-          fmt::join(req_it->addr_vec, ", ")
+          fmt::join(m_dram->get_preq_addr_vec(req_it->final_command, req_it->command, req_it->addr_vec), ", ")
         );
       }
 
@@ -25,6 +25,7 @@ private:
     ReqBuffer m_read_buffer;              // Read request buffer
     ReqBuffer m_write_buffer;             // Write request buffer
     ReqBuffer m_prac_buffer;              // Custom PRAC buffer
+    QueuedRequestCounts m_queued_reqs;    // Number of requests in the active, read and write buffers
     
     Request* m_prea_template;
     Request* m_rfmab_template;
@@ -83,8 +84,9 @@ public:
         m_bank_addr_idx = m_dram->m_levels("bank");
         m_row_addr_idx = m_dram->m_levels("row");
         m_priority_buffer.max_size = 512*3 + 32;
+        m_queued_reqs.setup(m_dram);
 
-        std::vector<int> all_bank_addr_vec(m_dram->m_levels.size(), -1);
+        AddrVec_t all_bank_addr_vec(m_dram->m_levels.size(), -1);
         all_bank_addr_vec[m_dram->m_levels("channel")] = m_channel_id;
         int m_prea_id = m_dram->m_commands("PREA");
         int m_rfmab_id = m_dram->m_commands("RFMab");
@@ -147,6 +149,7 @@ public:
             return false;
         }
 
+        m_queued_reqs.add(req);
         return true;
     };
 
@@ -158,6 +161,14 @@ public:
         return is_success;
     }
 
+    size_t get_priority_buffer_room() override {
+        return m_priority_buffer.max_size - m_priority_buffer.size();
+    };
+
+    size_t get_num_queued_requests(const AddrVec_t& addr_vec) override {
+        return m_queued_reqs.get(addr_vec);
+    };
+
     void tick() override {
         m_clk++;
         // Serve completed reads
@@ -191,6 +202,9 @@ public:
         // RowPolicy
         m_rowpolicy->update(request_found, req_it);
 
+        // Refresh manager
+        m_refresh->update(request_found, req_it);
+
         // Update all plugins
         for (auto plugin : m_plugins) {
             plugin->update(request_found, req_it);
@@ -198,10 +212,13 @@ public:
 
         // Issue the commands to serve the request
         if (request_found) {
-            m_dram->issue_command(req_it->command, req_it->addr_vec);
+            m_dram->issue_command(req_it->command, m_dram->get_preq_addr_vec(req_it->final_command, req_it->command, req_it->addr_vec));
 
             // If we are issuing the last command, set depart clock cycle and move the request to the pending queue
             if (req_it->command == req_it->final_command) {
+                if (buffer != &m_priority_buffer && buffer != &m_prac_buffer) {
+                    m_queued_reqs.remove(*req_it);
+                }
                 if (req_it->type_id == Request::Type::Read) {
                     req_it->depart = m_clk + m_dram->m_read_latency;
                     pending.push_back(*req_it);
@@ -213,6 +230,9 @@ public:
             }
             else if (m_dram->m_command_meta(req_it->command).is_opening) {
               if (m_active_buffer.enqueue(*req_it)) {
+                if (buffer == &m_priority_buffer || buffer == &m_prac_buffer) {
+                    m_queued_reqs.add(*req_it);
+                }
                 buffer->remove(req_it);
               }
             }
@@ -287,7 +307,7 @@ private:
             if (m_prac_buffer.size() != 0) {
                 req_buffer = &m_prac_buffer;
                 req_it = m_prac_buffer.begin();
-                req_it->command = m_dram->get_preq_command(req_it->final_command, req_it->addr_vec);
+                m_dram->update_preq_command(*req_it);
 
                 bool is_rfm = req_it->command == m_dram->m_commands("RFMab");
                 bool is_pre_rec = m_prac->get_state() == IPRAC::ABOState::PRE_RECOVERY;
@@ -302,10 +322,10 @@ private:
             if (m_priority_buffer.size() != 0) {
                 req_buffer = &m_priority_buffer;
                 req_it = m_priority_buffer.begin();
-                req_it->command = m_dram->get_preq_command(req_it->final_command, req_it->addr_vec);
+                m_dram->update_preq_command(*req_it);
 
                 bool fits = m_clk + m_prac->min_cycles_with_preall(req_it) < next_recovery_clk;
-                request_found = fits && m_dram->check_ready(req_it->command, req_it->addr_vec);
+                request_found = fits && m_dram->check_ready(req_it->command, m_dram->get_preq_addr_vec(req_it->final_command, req_it->command, req_it->addr_vec));
                 if (!request_found & m_priority_buffer.size() != 0) {
                     return false;
                 }
@@ -325,7 +345,7 @@ private:
         }
 
         if (request_found && m_dram->m_command_meta(req_it->command).is_closing) {
-            auto& rowgroup = req_it->addr_vec;
+            AddrVec_t rowgroup = m_dram->get_preq_addr_vec(req_it->final_command, req_it->command, req_it->addr_vec);
             for (auto _it = m_active_buffer.begin(); _it != m_active_buffer.end(); _it++) {
                 auto& _it_rowgroup = _it->addr_vec;
                 bool is_matching = true;
@@ -1,4 +1,5 @@
 #include <vector>
+#include <limits>
 
 #include "base/base.h"
 #include "dram_controller/controller.h"
@@ -43,9 +44,13 @@ class AllBankRefresh : public IRefreshManager, public Implementation {
       if (m_clk == m_next_refresh_cycle) {
         m_next_refresh_cycle += m_nrefi;
         for (int r = 0; r < m_num_ranks; r++) {
-          std::vector<int> addr_vec(m_dram_org_levels, -1);
+          AddrVec_t addr_vec(m_dram_org_levels, -1);
           addr_vec[0] = m_ctrl->m_channel_id;
           addr_vec[1] = r;
+          if (m_dram->check_self_refresh(addr_vec)) {
+            // The rank refreshes itself
+            continue;
+          }
           Request req(addr_vec, m_ref_req_id);
 
           bool is_success = m_ctrl->priority_send(req);
@@ -56,6 +61,174 @@ class AllBankRefresh : public IRefreshManager, public Implementation {
       }
     };
 
+    Clk_t get_next_event_clk(Clk_t clk) override {
+      return m_next_refresh_cycle;
+    };
+
+    void fast_forward(Clk_t clk) override {
+      m_clk = clk;
+    };
+
+};
+
+/**
+ * @brief     All-bank refresh with elastic (postponed and pulled-in) refreshes
+ * @details
+ * Every rank keeps a refresh credit: it drops by one every tREFI and rises by one for every refresh sent.
+ * A refresh falling due while the rank has queued requests is postponed, as long as at most max_postponed
+ * refreshes are owed. A rank that has been idle for idle_threshold cycles pulls refreshes in until it is
+ * max_pulled_in refreshes ahead. Only one refresh per rank is in flight at a time. The queued requests
+ * are counted by the controller, so checking every rank every cycle does not scan its queues.
+ *
+ */
+class ElasticAllBankRefresh : public IRefreshManager, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IRefreshManager, ElasticAllBankRefresh, "ElasticAllBank", "All-Bank Refresh scheme with refresh postponement and pull-in.")
+  private:
+    Clk_t m_clk = 0;
+    IDRAM* m_dram;
+    IDRAMController* m_ctrl;
+
+    int m_max_postponed = -1;
+    int m_max_pulled_in = -1;
+    Clk_t m_idle_threshold = -1;
+
+    int m_dram_org_levels = -1;
+    int m_rank_level = -1;
+    int m_num_ranks = -1;
+
+    int m_nrefi = -1;
+    int m_ref_req_id = -1;
+    int m_ref_cmd = -1;
+    Clk_t m_next_refresh_cycle = -1;
+
+    std::vector<AddrVec_t> m_rank_addr_vecs;
+    std::vector<int> m_credits;           // Number of refreshes each rank is ahead of (> 0) or behind (< 0) the schedule
+    std::vector<bool> m_is_in_flight;     // Whether a refresh sent to each rank is not issued yet
+    std::vector<Clk_t> m_last_busy_clk;   // The last cycle each rank had queued requests
+
+    size_t s_num_refreshes = 0;
+    size_t s_num_postponed_refreshes = 0;
+    size_t s_num_pulled_in_refreshes = 0;
+
+  public:
+    void init() override { 
+      m_ctrl = cast_parent<IDRAMController>();
+
+      m_max_postponed = param<int>("max_postponed").desc("Maximum number of refreshes that can be postponed.").default_val(8);
+      m_max_pulled_in = param<int>("max_pulled_in").desc("Maximum number of refreshes that can be pulled in.").default_val(8);
+      m_idle_threshold = param<Clk_t>("idle_threshold").desc("Number of idle cycles before a rank pulls in refreshes.").default_val(16);
+      if (m_max_postponed < 0 || m_max_pulled_in < 0) {
+        throw ConfigurationError("max_postponed ({}) and max_pulled_in ({}) cannot be negative!", m_max_postponed, m_max_pulled_in);
+      }
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_dram = m_ctrl->m_dram;
+
+      m_dram_org_levels = m_dram->m_levels.size();
+      m_rank_level = m_dram->m_levels("rank");
+      m_num_ranks = m_dram->get_level_size("rank");
+
+      m_nrefi = m_dram->m_timing_vals("nREFI");
+      m_ref_req_id = m_dram->m_requests("all-bank-refresh");
+      m_ref_cmd = m_dram->m_request_translations(m_ref_req_id);
+
+      m_next_refresh_cycle = m_nrefi;
+
+      for (int r = 0; r < m_num_ranks; r++) {
+        AddrVec_t addr_vec(m_dram_org_levels, -1);
+        addr_vec[0] = m_ctrl->m_channel_id;
+        addr_vec[m_rank_level] = r;
+        m_rank_addr_vecs.push_back(addr_vec);
+      }
+      m_credits.resize(m_num_ranks, 0);
+      m_is_in_flight.resize(m_num_ranks, false);
+      m_last_busy_clk.resize(m_num_ranks, 0);
+
+      register_stat(s_num_refreshes).name("num_refreshes_{}", m_ctrl->m_channel_id);
+      register_stat(s_num_postponed_refreshes).name("num_postponed_refreshes_{}", m_ctrl->m_channel_id);
+      register_stat(s_num_pulled_in_refreshes).name("num_pulled_in_refreshes_{}", m_ctrl->m_channel_id);
+    };
+
+    void tick() {
+      m_clk++;
+
+      bool is_due = false;
+      if (m_clk == m_next_refresh_cycle) {
+        m_next_refresh_cycle += m_nrefi;
+        is_due = true;
+      }
+
+      for (int r = 0; r < m_num_ranks; r++) {
+        const AddrVec_t& addr_vec = m_rank_addr_vecs[r];
+        if (m_dram->check_self_refresh(addr_vec)) {
+          // The rank refreshes itself
+          continue;
+        }
+
+        bool is_busy = m_ctrl->get_num_queued_requests(addr_vec) > 0;
+        if (is_busy) {
+          m_last_busy_clk[r] = m_clk;
+        }
+
+        if (is_due) {
+          m_credits[r]--;
+          if (m_credits[r] < 0 && (is_busy || m_is_in_flight[r]) && m_credits[r] >= -m_max_postponed) {
+            s_num_postponed_refreshes++;
+          }
+        }
+
+        if (m_is_in_flight[r]) {
+          continue;
+        }
+
+        if (m_credits[r] < -m_max_postponed || (m_credits[r] < 0 && !is_busy)) {
+          send_refresh(r, addr_vec);
+        } else if (m_credits[r] < m_max_pulled_in && m_clk - m_last_busy_clk[r] >= m_idle_threshold) {
+          if (send_refresh(r, addr_vec)) {
+            s_num_pulled_in_refreshes++;
+          }
+        }
+      }
+    };
+
+    void update(bool request_found, ReqBuffer::iterator& req_it) override {
+      if (request_found && req_it->command == m_ref_cmd) {
+        m_is_in_flight[req_it->addr_vec[m_rank_level]] = false;
+      }
+    };
+
+    Clk_t get_next_event_clk(Clk_t clk) override {
+      Clk_t next_clk = m_next_refresh_cycle;
+      for (int r = 0; r < m_num_ranks; r++) {
+        if (m_is_in_flight[r] || m_dram->check_self_refresh(m_rank_addr_vecs[r])) {
+          continue;
+        }
+        if (m_credits[r] < 0) {
+          return clk + 1;
+        } else if (m_credits[r] < m_max_pulled_in) {
+          next_clk = std::min(next_clk, std::max(m_last_busy_clk[r] + m_idle_threshold, clk + 1));
+        }
+      }
+      return next_clk;
+    };
+
+    void fast_forward(Clk_t clk) override {
+      m_clk = clk;
+    };
+
+  private:
+    bool send_refresh(int rank, const AddrVec_t& addr_vec) {
+      Request req(addr_vec, m_ref_req_id);
+      if (!m_ctrl->priority_send(req)) {
+        // Retry at the next cycle
+        return false;
+      }
+      m_credits[rank]++;
+      m_is_in_flight[rank] = true;
+      s_num_refreshes++;
+      return true;
+    };
 };
 
 }       // namespace Ramulator
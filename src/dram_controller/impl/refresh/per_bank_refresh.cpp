@@ -0,0 +1,239 @@
+#include <vector>
+#include <limits>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/refresh.h"
+
+namespace Ramulator {
+
+/**
+ * @brief     Per-bank refresh scheme
+ * @details
+ * A per-bank refresh (e.g., LPDDR REFpb) refreshes a pair of banks, so a rank needs one refresh per pair
+ * every tREFI. A refresh becomes due every tREFI / #pairs, and every pair is refreshed once per round
+ * in any order. Pairs without queued requests are preferred (closed ones first) so that refreshes do not
+ * stall demand requests. If every remaining pair stays busy, the refresh is postponed up to max_postponed
+ * times before the next pair in the rotation is refreshed anyway.
+ *
+ * The device closes the addressed bank of a pair by itself, while an open partner bank is closed with a
+ * separate close-row request sent ahead of the refresh. A refresh is only sent once its timing constraints
+ * (e.g., tPBR2PBR) are met, as it would otherwise block the priority buffer.
+ *
+ */
+class PerBankRefresh : public IRefreshManager, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IRefreshManager, PerBankRefresh, "PerBank", "Per-Bank Refresh scheme.")
+  private:
+    Clk_t m_clk = 0;
+    IDRAM* m_dram;
+    IDRAMController* m_ctrl;
+
+    int m_max_postponed = -1;
+
+    int m_dram_org_levels = -1;
+    int m_rank_level = -1;
+    int m_bankgroup_level = -1;
+    int m_bank_level = -1;
+    int m_num_ranks = -1;
+    int m_num_banks = -1;
+    int m_num_pairs = -1;
+
+    int m_nrefi_pb = -1;
+    int m_npbr2pbr = 0;
+    int m_ref_req_id = -1;
+    int m_close_req_id = -1;
+    int m_ref_cmd = -1;
+    int m_rd_cmd = -1;
+    Clk_t m_next_refresh_cycle = -1;
+
+    std::vector<int> m_num_due;                         // Number of refreshes due at each rank
+    std::vector<int> m_next_pair;                       // Next pair in the rotation of each rank
+    std::vector<std::vector<bool>> m_is_refreshed;      // Pairs of each rank refreshed in the current round
+    std::vector<int> m_num_refreshed;
+    std::vector<Clk_t> m_last_refresh_clk;              // The last cycle a refresh was sent to each rank
+
+    size_t s_num_refreshes = 0;
+    size_t s_num_forced_refreshes = 0;
+
+  public:
+    void init() override {
+      m_ctrl = cast_parent<IDRAMController>();
+      m_max_postponed = param<int>("max_postponed").desc("Maximum number of per-bank refreshes postponed while all remaining banks are busy.").default_val(8);
+      if (m_max_postponed < 1) {
+        throw ConfigurationError("max_postponed ({}) must be at least 1!", m_max_postponed);
+      }
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_dram = m_ctrl->m_dram;
+
+      for (auto req_name : {"per-bank-refresh", "close-row"}) {
+        if (!m_dram->m_requests.contains(req_name)) {
+          throw ConfigurationError("DRAM standard {} does not support request: {}!", m_dram->get_name(), req_name);
+        }
+      }
+      m_ref_req_id = m_dram->m_requests("per-bank-refresh");
+      m_close_req_id = m_dram->m_requests("close-row");
+      m_ref_cmd = m_dram->m_request_translations(m_ref_req_id);
+      m_rd_cmd = m_dram->m_request_translations(m_dram->m_requests("read"));
+
+      m_dram_org_levels = m_dram->m_levels.size();
+      m_rank_level = m_dram->m_levels("rank");
+      m_bankgroup_level = m_dram->m_levels("bankgroup");
+      m_bank_level = m_dram->m_levels("bank");
+      m_num_ranks = m_dram->get_level_size("rank");
+      m_num_banks = m_dram->get_level_size("bank");
+      m_num_pairs = m_dram->get_level_size("bankgroup") * m_num_banks / 2;
+
+      m_nrefi_pb = m_dram->m_timing_vals("nREFI") / m_num_pairs;
+      m_next_refresh_cycle = m_nrefi_pb;
+      if (m_dram->m_timings.contains("nPBR2PBR")) {
+        m_npbr2pbr = m_dram->m_timing_vals("nPBR2PBR");
+      }
+
+      m_num_due.resize(m_num_ranks, 0);
+      m_next_pair.resize(m_num_ranks, 0);
+      m_is_refreshed.resize(m_num_ranks, std::vector<bool>(m_num_pairs, false));
+      m_num_refreshed.resize(m_num_ranks, 0);
+      m_last_refresh_clk.resize(m_num_ranks, -m_npbr2pbr);
+
+      register_stat(s_num_refreshes).name("num_per_bank_refreshes_{}", m_ctrl->m_channel_id);
+      register_stat(s_num_forced_refreshes).name("num_forced_per_bank_refreshes_{}", m_ctrl->m_channel_id);
+    };
+
+    void tick() {
+      m_clk++;
+
+      if (m_clk == m_next_refresh_cycle) {
+        m_next_refresh_cycle += m_nrefi_pb;
+        for (int r = 0; r < m_num_ranks; r++) {
+          if (m_dram->check_self_refresh(get_addr_vec(r, -1))) {
+            // The rank refreshes itself
+            m_num_due[r] = 0;
+            continue;
+          }
+          m_num_due[r]++;
+        }
+      }
+
+      for (int r = 0; r < m_num_ranks; r++) {
+        if (m_num_due[r] > 0) {
+          try_refresh(r);
+        }
+      }
+    };
+
+    Clk_t get_next_event_clk(Clk_t clk) override {
+      for (int r = 0; r < m_num_ranks; r++) {
+        if (m_num_due[r] > 0) {
+          // Waiting for an idle pair
+          return clk + 1;
+        }
+      }
+      return m_next_refresh_cycle;
+    };
+
+    void fast_forward(Clk_t clk) override {
+      m_clk = clk;
+    };
+
+  private:
+    /**
+     * @brief    Returns the address of the first bank of the pair (or of the rank if pair is -1).
+     */
+    AddrVec_t get_addr_vec(int rank, int pair) {
+      AddrVec_t addr_vec(m_dram_org_levels, -1);
+      addr_vec[0] = m_ctrl->m_channel_id;
+      addr_vec[m_rank_level] = rank;
+      if (pair >= 0) {
+        addr_vec[m_bankgroup_level] = pair / m_num_banks;
+        addr_vec[m_bank_level] = pair % m_num_banks;
+      }
+      return addr_vec;
+    };
+
+    AddrVec_t get_partner_addr_vec(int rank, int pair) {
+      return get_addr_vec(rank, pair + m_num_pairs);
+    };
+
+    bool is_idle(int rank, int pair) {
+      return m_ctrl->get_num_queued_requests(get_addr_vec(rank, pair)) == 0 &&
+             m_ctrl->get_num_queued_requests(get_partner_addr_vec(rank, pair)) == 0;
+    };
+
+    bool is_closed(int rank, int pair) {
+      return !m_dram->check_node_open(m_rd_cmd, get_addr_vec(rank, pair)) &&
+             !m_dram->check_node_open(m_rd_cmd, get_partner_addr_vec(rank, pair));
+    };
+
+    void try_refresh(int rank) {
+      // The previous refresh may still be queued, in which case the device does not know about it yet
+      if (m_clk < m_last_refresh_clk[rank] + m_npbr2pbr) {
+        return;
+      }
+
+      // Pick an idle pair that is not refreshed in this round yet, preferring closed ones
+      int idle_pair = -1;
+      for (int i = 0; i < m_num_pairs; i++) {
+        int pair = (m_next_pair[rank] + i) % m_num_pairs;
+        if (m_is_refreshed[rank][pair] || !is_idle(rank, pair)) {
+          continue;
+        }
+        if (is_closed(rank, pair)) {
+          idle_pair = pair;
+          break;
+        } else if (idle_pair == -1) {
+          idle_pair = pair;
+        }
+      }
+
+      int pair = idle_pair;
+      if (pair == -1) {
+        if (m_num_due[rank] < m_max_postponed) {
+          return;
+        }
+        // Postponed too long: refresh the next pair in the rotation even though it is busy
+        pair = m_next_pair[rank];
+        while (m_is_refreshed[rank][pair]) {
+          pair = (pair + 1) % m_num_pairs;
+        }
+      }
+
+      // A refresh waiting for e.g. tPBR2PBR at the head of the priority buffer would stall all other requests
+      AddrVec_t addr_vec = get_addr_vec(rank, pair);
+      if (m_dram->get_ready_clk(m_ref_cmd, addr_vec) > m_clk + 1) {
+        return;
+      }
+
+      // The close request must not be sent without the refresh, so both have to fit in the priority buffer
+      AddrVec_t partner_addr_vec = get_partner_addr_vec(rank, pair);
+      bool close_partner = m_dram->check_node_open(m_rd_cmd, partner_addr_vec);
+      if (m_ctrl->get_priority_buffer_room() < (close_partner ? 2 : 1)) {
+        return;
+      }
+      if (close_partner) {
+        Request close_req(partner_addr_vec, m_close_req_id);
+        m_ctrl->priority_send(close_req);
+      }
+      Request req(addr_vec, m_ref_req_id);
+      if (!m_ctrl->priority_send(req)) {
+        // Only if the controller does not report its room; retry in the next cycle
+        return;
+      }
+      if (idle_pair == -1) {
+        s_num_forced_refreshes++;
+      }
+      s_num_refreshes++;
+      m_num_due[rank]--;
+      m_last_refresh_clk[rank] = m_clk;
+
+      m_is_refreshed[rank][pair] = true;
+      m_next_pair[rank] = (pair + 1) % m_num_pairs;
+      if (++m_num_refreshed[rank] == m_num_pairs) {
+        m_is_refreshed[rank].assign(m_num_pairs, false);
+        m_num_refreshed[rank] = 0;
+      }
+    };
+};
+
+}       // namespace Ramulator
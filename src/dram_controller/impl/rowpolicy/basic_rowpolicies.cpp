@@ -1,4 +1,5 @@
 #include <vector>
+#include <limits>
 
 #include "base/base.h"
 #include "dram_controller/controller.h"
@@ -20,6 +21,10 @@ class OpenRowPolicy : public IRowPolicy, public Implementation {
       // OpenRowPolicy does not need to take any actions
     };
 
+    Clk_t get_next_event_clk(Clk_t clk) override {
+      return std::numeric_limits<Clk_t>::max();
+    };
+
 
 };
 
@@ -116,6 +121,89 @@ class ClosedRowPolicy : public IRowPolicy, public Implementation {
         }
       }
     };
+
+    Clk_t get_next_event_clk(Clk_t clk) override {
+      // Only reacts to scheduled requests
+      return std::numeric_limits<Clk_t>::max();
+    };
+};
+
+/**
+ * @brief     Closed-page policy that closes rows with auto-precharge reads and writes
+ * @details
+ * When the final RD/WR of a request is scheduled and no other queued request hits the same row,
+ * the command is replaced with its auto-precharge variant (e.g., RDA/WRA), so the row is closed
+ * without spending a command bus slot on a separate PRE.
+ *
+ */
+class AutoPrechargeRowPolicy : public IRowPolicy, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IRowPolicy, AutoPrechargeRowPolicy, "AutoPrechargeRowPolicy", "Closed Row Policy with Auto-Precharge.")
+  private:
+    IDRAM* m_dram;
+
+    int m_RD_cmd = -1;
+    int m_WR_cmd = -1;
+    int m_RDA_cmd = -1;
+    int m_WRA_cmd = -1;
+
+    int m_column_level = -1;
+
+    size_t s_num_autoprecharges = 0;
+
+  public:
+    void init() override { };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_ctrl = cast_parent<IDRAMController>();
+      m_dram = m_ctrl->m_dram;
+
+      for (auto req_name : {"read", "write", "read-autoprecharge", "write-autoprecharge"}) {
+        if (!m_dram->m_requests.contains(req_name)) {
+          throw ConfigurationError("DRAM standard {} does not support request: {}!", m_dram->get_name(), req_name);
+        }
+      }
+      m_RD_cmd = m_dram->m_request_translations(m_dram->m_requests("read"));
+      m_WR_cmd = m_dram->m_request_translations(m_dram->m_requests("write"));
+      m_RDA_cmd = m_dram->m_request_translations(m_dram->m_requests("read-autoprecharge"));
+      m_WRA_cmd = m_dram->m_request_translations(m_dram->m_requests("write-autoprecharge"));
+
+      m_column_level = m_dram->m_levels("column");
+
+      register_stat(s_num_autoprecharges).name("num_autoprecharges_{}", m_ctrl->m_channel_id);
+    };
+
+    void update(bool request_found, ReqBuffer::iterator& req_it) override {
+      if (!request_found || req_it->command != req_it->final_command) {
+        return;
+      }
+
+      int ap_cmd = -1;
+      if (req_it->command == m_RD_cmd) {
+        ap_cmd = m_RDA_cmd;
+      } else if (req_it->command == m_WR_cmd) {
+        ap_cmd = m_WRA_cmd;
+      } else {
+        return;
+      }
+
+      // The scheduled request itself is still queued, so any other request to the row is a pending hit
+      AddrVec_t row_addr_vec = req_it->addr_vec;
+      row_addr_vec[m_column_level] = -1;
+      if (m_ctrl->get_num_queued_requests(row_addr_vec) > 1) {
+        return;
+      }
+
+      if (m_dram->check_ready(ap_cmd, req_it->addr_vec)) {
+        req_it->command = ap_cmd;
+        req_it->final_command = ap_cmd;
+        s_num_autoprecharges++;
+      }
+    };
+
+    Clk_t get_next_event_clk(Clk_t clk) override {
+      // Only reacts to scheduled requests
+      return std::numeric_limits<Clk_t>::max();
+    };
 };
 
 }       // namespace Ramulator
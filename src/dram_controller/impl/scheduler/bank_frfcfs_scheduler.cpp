@@ -0,0 +1,163 @@
+#include <vector>
+#include <unordered_map>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/scheduler.h"
+
+namespace Ramulator {
+
+/**
+ * @brief     FRFCFS scheduler with per-bank request queues
+ * @details
+ * Picks the same request as FRFCFS (the oldest ready request, or else the oldest request), but groups the
+ * buffers it schedules by bank. The prerequisite commands of the requests to a bank are only queried again
+ * once the state epoch of the bank changes (see IDRAM::get_state_epoch), and the requests to a bank that
+ * wait for the same command share one readiness check. The device is thus queried once per bank with work
+ * and command rather than once per request.
+ *
+ */
+class BankFRFCFS : public IScheduler, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IScheduler, BankFRFCFS, "BankFRFCFS", "FRFCFS DRAM Scheduler with per-bank request queues.")
+  private:
+    struct BankCache {
+      int64_t epoch = -1;         // The state epoch at which the prerequisites of the bank were queried
+      uint64_t num_linked = 0;    // Number of requests added to the bank before that
+    };
+
+    IDRAM* m_dram;
+
+    int m_row_level = -1;
+    std::vector<int> m_level_sizes;
+    int m_num_banks = -1;         // Requests without a bank (e.g., to a whole rank) share an extra group
+
+    std::unordered_map<ReqBuffer*, std::vector<BankCache>> m_bank_caches;
+    std::vector<std::pair<int, bool>> m_ready_cmds;   // Readiness of the commands of the current bank
+
+  public:
+    void init() override { };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_dram = cast_parent<IDRAMController>()->m_dram;
+
+      m_row_level = m_dram->m_levels("row");
+      m_level_sizes.resize(m_row_level, 1);
+      m_num_banks = 1;
+      for (int level = 1; level < m_row_level; level++) {
+        m_level_sizes[level] = std::max(m_dram->m_organization.count[level], 1);
+        m_num_banks *= m_level_sizes[level];
+      }
+    };
+
+    ReqBuffer::iterator compare(ReqBuffer::iterator req1, ReqBuffer::iterator req2) override {
+      bool ready1 = m_dram->check_ready(req1->command, req1->addr_vec);
+      bool ready2 = m_dram->check_ready(req2->command, req2->addr_vec);
+
+      if (ready1 ^ ready2) {
+        if (ready1) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      // Fallback to FCFS
+      if (req1->arrive <= req2->arrive) {
+        return req1;
+      } else {
+        return req2;
+      }
+    }
+
+    ReqBuffer::iterator get_best_request(ReqBuffer& buffer) override {
+      if (buffer.size() == 0) {
+        return buffer.end();
+      }
+
+      auto caches_it = m_bank_caches.find(&buffer);
+      if (caches_it == m_bank_caches.end()) {
+        buffer.set_groups(m_num_banks + 1, [this] (const Request& req) { return get_bank_id(req); });
+        caches_it = m_bank_caches.emplace(&buffer, std::vector<BankCache>(m_num_banks + 1)).first;
+      }
+      std::vector<BankCache>& caches = caches_it->second;
+
+      auto candidate = buffer.end();
+      bool candidate_ready = false;
+      for (int bank_id : buffer.get_active_groups()) {
+        const ReqBuffer::Group& group = buffer.get_group(bank_id);
+        bool is_bank = bank_id != m_num_banks;
+        update_preqs(buffer, group, caches[bank_id], is_bank);
+
+        m_ready_cmds.clear();
+        for (int slot_id = group.head; slot_id != -1; slot_id = buffer.get_group_next(slot_id)) {
+          auto it = buffer.at(slot_id);
+          bool ready = is_bank ? check_bank_ready(*it) : m_dram->check_ready(it->command, it->addr_vec);
+          // Ties are broken by the buffer order, as in FRFCFS
+          if (candidate == buffer.end() || (ready && !candidate_ready) ||
+              (ready == candidate_ready && (it->arrive < candidate->arrive ||
+                                            (it->arrive == candidate->arrive && buffer.get_seq(slot_id) < buffer.get_seq(candidate.slot_id()))))) {
+            candidate = it;
+            candidate_ready = ready;
+          }
+        }
+      }
+      return candidate;
+    }
+
+  private:
+    int get_bank_id(const Request& req) {
+      int bank_id = 0;
+      for (int level = 1; level < m_row_level; level++) {
+        if (req.addr_vec[level] < 0) {
+          return m_num_banks;
+        }
+        bank_id = bank_id * m_level_sizes[level] + req.addr_vec[level];
+      }
+      return bank_id;
+    };
+
+    /**
+     * @brief    Queries the prerequisites of the requests to a bank that may have changed since the last call.
+     * @details
+     * If the state epoch of the bank is unchanged, only the requests added since then (i.e., at the back of
+     * its queue) are new.
+     */
+    void update_preqs(ReqBuffer& buffer, const ReqBuffer::Group& group, BankCache& cache, bool is_bank) {
+      if (!is_bank) {
+        // Requests without a bank may each address a different node
+        for (int slot_id = group.head; slot_id != -1; slot_id = buffer.get_group_next(slot_id)) {
+          m_dram->update_preq_command(*buffer.at(slot_id));
+        }
+        return;
+      }
+
+      int64_t epoch = m_dram->get_state_epoch(buffer.at(group.head)->addr_vec);
+      size_t num_stale = group.size;
+      if (epoch != -1 && epoch == cache.epoch) {
+        num_stale = std::min<uint64_t>(group.num_linked - cache.num_linked, group.size);
+      }
+      for (int slot_id = group.tail; num_stale > 0; slot_id = buffer.get_group_prev(slot_id), num_stale--) {
+        Request& req = *buffer.at(slot_id);
+        req.command = m_dram->get_preq_command(req.final_command, req.addr_vec);
+        req.preq_epoch = epoch;
+      }
+      cache.epoch = epoch;
+      cache.num_linked = group.num_linked;
+    };
+
+    /**
+     * @brief    Checks whether a request of the current bank is ready, once per command.
+     */
+    bool check_bank_ready(const Request& req) {
+      for (const auto& [command, ready] : m_ready_cmds) {
+        if (command == req.command) {
+          return ready;
+        }
+      }
+      bool ready = m_dram->check_ready(req.command, req.addr_vec);
+      m_ready_cmds.push_back({req.command, ready});
+      return ready;
+    };
+};
+
+}       // namespace Ramulator
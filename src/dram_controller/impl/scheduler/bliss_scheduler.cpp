@@ -77,7 +77,7 @@ class BLISSScheduler : public IBHScheduler, public Implementation {
       }
 
       for (auto& req : buffer) {
-        req.command = m_dram->get_preq_command(req.final_command, req.addr_vec);
+        m_dram->update_preq_command(req);
 
         // Check if the request is safe to issue
         bool blisted = m_bliss->is_blacklisted(req.source_id);
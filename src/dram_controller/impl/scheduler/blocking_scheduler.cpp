@@ -60,7 +60,7 @@ class BlockingScheduler : public IBHScheduler, public Implementation {
       }
 
       for (auto& req : buffer) {
-        req.command = m_dram->get_preq_command(req.final_command, req.addr_vec);
+        m_dram->update_preq_command(req);
       }
 
       auto candidate = buffer.begin();
@@ -43,13 +43,17 @@ class FRFCFS : public IScheduler, public Implementation {
         return buffer.end();
       }
 
-      for (auto& req : buffer) {
-        req.command = m_dram->get_preq_command(req.final_command, req.addr_vec);
-      }
-
-      auto candidate = buffer.begin();
-      for (auto next = std::next(buffer.begin(), 1); next != buffer.end(); next++) {
-        candidate = compare(candidate, next);
+      // Same order as folding compare() over the buffer, but checks every request only once
+      auto candidate = buffer.end();
+      bool candidate_ready = false;
+      for (auto it = buffer.begin(); it != buffer.end(); it++) {
+        m_dram->update_preq_command(*it);
+        bool ready = m_dram->check_ready(it->command, it->addr_vec);
+        if (candidate == buffer.end() || (ready && !candidate_ready) ||
+            (ready == candidate_ready && it->arrive < candidate->arrive)) {
+          candidate = it;
+          candidate_ready = ready;
+        }
       }
       return candidate;
     }
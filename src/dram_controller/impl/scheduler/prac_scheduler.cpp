@@ -80,7 +80,7 @@ public:
 
         Clk_t next_recovery = m_prac->next_recovery_cycle();
         for (auto& req : buffer) {
-            req.command = m_dram->get_preq_command(req.final_command, req.addr_vec);
+            m_dram->update_preq_command(req);
             req.scratchpad[FITS_IDX] = m_clk + m_prac->min_cycles_with_preall(req) < next_recovery;
             req.scratchpad[READY_IDX] = m_dram->check_ready(req.command, req.addr_vec);
         }
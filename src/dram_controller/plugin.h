@@ -18,6 +18,19 @@ class IControllerPlugin {
 
   public:
     virtual void update(bool request_found, ReqBuffer::iterator& req_it) = 0;
+
+    /**
+     * @brief    Returns the earliest cycle at which update() can take an action when no request is scheduled.
+     * @details  The default (the next cycle) disables fast-forwarding of the controller.
+     * 
+     */
+    virtual Clk_t get_next_event_clk(Clk_t clk) { return clk + 1; };
+
+    /**
+     * @brief    Advances the clock of the plugin to the given cycle, skipping the update() calls in between.
+     * 
+     */
+    virtual void fast_forward(Clk_t clk) {};
 };
 
 }        // namespace Ramulator
@@ -14,6 +14,24 @@ class IRefreshManager {
 
   public:
     virtual void tick() = 0;
+
+    /**
+     * @brief    Called every cycle with the request (if any) whose command is about to be issued.
+     * 
+     */
+    virtual void update(bool request_found, ReqBuffer::iterator& req_it) {};
+
+    /**
+     * @brief    Returns the earliest cycle at which tick() will issue a refresh. The default disables fast-forwarding.
+     * 
+     */
+    virtual Clk_t get_next_event_clk(Clk_t clk) { return clk + 1; };
+
+    /**
+     * @brief    Advances the clock to the given cycle, which must be before get_next_event_clk().
+     * 
+     */
+    virtual void fast_forward(Clk_t clk) {};
 };
 
 }        // namespace Ramulator
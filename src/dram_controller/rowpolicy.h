@@ -16,6 +16,13 @@ class IRowPolicy {
 
   public:
     virtual void update(bool request_found, ReqBuffer::iterator& req_it) = 0;
+
+    /**
+     * @brief    Returns the earliest cycle at which update() can take an action when no request is scheduled.
+     * @details  The default (the next cycle) disables fast-forwarding of the controller.
+     * 
+     */
+    virtual Clk_t get_next_event_clk(Clk_t clk) { return clk + 1; };
 };
 
 }        // namespace Ramulator
@@ -47,6 +47,21 @@ class IFrontEnd : public Clocked<IFrontEnd>, public TopLevel<IFrontEnd> {
 
     int get_clock_ratio() { return m_clock_ratio; };
 
+    /**
+     * @brief    Returns how many of the following ticks are guaranteed to do nothing but advance the clock
+     * @details
+     * The simulation loop uses this to skip idle stretches (e.g., non-memory instructions) with fast_forward().
+     * Frontends that cannot tell return 0 and are ticked every cycle.
+     * 
+     */
+    virtual Clk_t get_idle_cycles() { return 0; };
+
+    /**
+     * @brief    Skips the given number of idle ticks (at most get_idle_cycles())
+     * 
+     */
+    virtual void fast_forward(Clk_t cycles) {};
+
     /**
      * @brief    Receives memory requests from external sources (e.g., coming from a full system simulator like GEM5)
      * 
@@ -55,8 +55,6 @@ class Simple_rw_processor final : public IFrontEnd, public Implementation {
         m_logger->info("Processor Heartbeat {} cycles.", m_clk);
       }
 
-      m_clk++;
-
       if (s_insts_retired >= m_num_expected_insts) {
         reached_expected_num_insts = true;
         return;
@@ -90,6 +88,19 @@ class Simple_rw_processor final : public IFrontEnd, public Implementation {
       }
     }
 
+    Clk_t get_idle_cycles() override {
+      if (s_insts_retired >= m_num_expected_insts) {
+        return 0;
+      }
+      // The following ticks only count down the bubbles of the current instruction
+      return std::max(m_trace->m_trace[m_cur_inst].bubble_count - m_cur_bubble, 0);
+    };
+
+    void fast_forward(Clk_t cycles) override {
+      m_clk += cycles;
+      m_cur_bubble += cycles;
+    };
+
     void receive(Request& req) {
 
     };
@@ -20,6 +20,9 @@ int main(int argc, char* argv[]) {
   program.add_argument("-p", "--param").metavar("KEY=VALUE")
     .append()
     .help("Specify parameter to override in the configuration file. Repeat this option to change multiple parameters.");
+  program.add_argument("--no-fast-forward")
+    .default_value(false).implicit_value(true)
+    .help("Tick every cycle instead of skipping the cycles in which neither the frontend nor the memory system can make progress.");
 
   try {
     program.parse_args(argc, argv);
@@ -97,7 +100,22 @@ int main(int argc, char* argv[]) {
 
   int tick_mult = frontend_tick * mem_tick;
 
+  bool fast_forward = !program.get<bool>("--no-fast-forward");
+
   for (uint64_t i = 0;; i++) {
+    // Skip whole blocks of ticks in which both the frontend and the memory system are idle
+    if (fast_forward && (i % tick_mult) == 0) {
+      Ramulator::Clk_t num_blocks = frontend->get_idle_cycles() / frontend_tick;
+      if (num_blocks > 0) {
+        num_blocks = std::min(num_blocks, memory_system->get_idle_cycles() / mem_tick);
+      }
+      if (num_blocks > 0) {
+        frontend->fast_forward(num_blocks * frontend_tick);
+        memory_system->fast_forward(num_blocks * mem_tick);
+        i += num_blocks * tick_mult;
+      }
+    }
+
     if (((i % tick_mult) % mem_tick) == 0) {
       frontend->tick();
     }
@@ -80,6 +80,22 @@ class GenericDRAMSystem final : public IMemorySystem, public Implementation {
       }
     };
 
+    Clk_t get_idle_cycles() override {
+      Clk_t next_clk = m_dram->get_next_event_clk();
+      for (auto controller : m_controllers) {
+        next_clk = std::min(next_clk, controller->get_next_event_clk());
+      }
+      return next_clk - m_clk - 1;
+    };
+
+    void fast_forward(Clk_t cycles) override {
+      m_clk += cycles;
+      m_dram->fast_forward(m_clk);
+      for (auto controller : m_controllers) {
+        controller->fast_forward(m_clk);
+      }
+    };
+
     float get_tCK() override {
       return m_dram->m_timing_vals("tCK_ps") / 1000.0f;
     }
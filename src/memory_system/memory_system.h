@@ -63,6 +63,20 @@ class IMemorySystem : public TopLevel<IMemorySystem> {
      */
     int get_clock_ratio() { return m_clock_ratio; };
 
+    /**
+     * @brief    Returns how many of the following ticks are guaranteed to do nothing but advance the clock
+     * @details
+     * Assumes that no new request arrives in the meantime. Memory systems that cannot tell return 0.
+     * 
+     */
+    virtual Clk_t get_idle_cycles() { return 0; };
+
+    /**
+     * @brief    Skips the given number of idle ticks (at most get_idle_cycles())
+     * 
+     */
+    virtual void fast_forward(Clk_t cycles) {};
+
     // /**
     //  * @brief    Get the integer id of the request type from the memory spec
     //  * 
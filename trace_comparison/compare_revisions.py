@@ -0,0 +1,213 @@
+import os
+import sys
+import glob
+import filecmp
+import argparse
+import subprocess
+import yaml
+
+
+# Some constants
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_DIR = os.path.dirname(SCRIPT_DIR)
+TRACE_GENERATOR = os.path.join(REPO_DIR, "perf_comparison", "traces", "trace_generator.py")
+
+
+def parse_arg():
+  parser = argparse.ArgumentParser(
+    description="Check that two revisions of Ramulator 2.0, or several schedulers, issue the same DRAM commands and report the same statistics."
+  )
+
+  parser.add_argument(
+    "--base", "-b", type=str, dest="base_rev",
+    help="The revision to compare against (e.g., the parent of the commit under test). Without it, only the schedulers of the head revision are compared."
+  )
+
+  parser.add_argument(
+    "--head", type=str, dest="head_rev", default="HEAD",
+    help="The revision under test."
+  )
+
+  parser.add_argument(
+    "--configs", "-c", type=str, nargs="+", dest="configs",
+    default=sorted(glob.glob(os.path.join(SCRIPT_DIR, "configs", "*.yaml"))),
+    help="The configurations to simulate. The script sets the trace and the command trace paths."
+  )
+
+  parser.add_argument(
+    "--patterns", "-p", type=str, nargs="+", dest="patterns",
+    choices=["stream", "random"], default=["stream", "random"],
+    help="The memory access patterns of the simulated traces."
+  )
+
+  parser.add_argument(
+    "--schedulers", "-s", type=str, nargs="+", dest="schedulers",
+    help="The schedulers to simulate instead of the one in the configurations. Every scheduler is compared against the first one."
+  )
+
+  parser.add_argument(
+    "--num_reqs", "-n", type=int, dest="num_reqs",
+    default=100000,
+    help="The number of memory requests in each trace."
+  )
+
+  parser.add_argument(
+    "--work_dir", "-w", type=str, dest="work_dir",
+    default=os.path.join(SCRIPT_DIR, "work"),
+    help="Where the revisions are checked out and built, and the outputs are written."
+  )
+
+  parser.add_argument(
+    "--cmake_arg", type=str, action="append", dest="cmake_args",
+    default=[],
+    help="An extra argument to configure the builds with (e.g., --cmake_arg=-DFETCHCONTENT_SOURCE_DIR_SPDLOG=...). Repeat this option to pass multiple arguments."
+  )
+
+  parser.add_argument(
+    "--jobs", "-j", type=int, dest="jobs",
+    default=os.cpu_count(),
+    help="The number of parallel build jobs."
+  )
+
+  return parser.parse_args()
+
+
+def run_cmd(args, **kwargs):
+  print(f"Running {' '.join(args)}...")
+  subprocess.run(args, check = True, **kwargs)
+
+
+def build_revision(rev, args):
+  sha = subprocess.run(
+    ["git", "-C", REPO_DIR, "rev-parse", "--short", rev],
+    check = True, capture_output = True, text = True
+  ).stdout.strip()
+
+  src_dir = os.path.join(args.work_dir, "src", sha)
+  build_dir = os.path.join(args.work_dir, "build", sha)
+  if not os.path.exists(src_dir):
+    run_cmd(["git", "-C", REPO_DIR, "worktree", "add", "--detach", src_dir, sha])
+  run_cmd(["cmake", "-S", src_dir, "-B", build_dir, "-DCMAKE_BUILD_TYPE=Release"] + args.cmake_args, stdout = subprocess.DEVNULL)
+  run_cmd(["cmake", "--build", build_dir, f"-j{args.jobs}"], stdout = subprocess.DEVNULL)
+
+  return sha, os.path.join(build_dir, "ramulator2")
+
+
+def generate_trace(pattern, args):
+  trace_file = os.path.join(args.work_dir, "traces", f"{pattern}_{args.num_reqs}_R8W2.trace")
+  if not os.path.exists(trace_file):
+    os.makedirs(os.path.dirname(trace_file), exist_ok = True)
+    run_cmd([
+      sys.executable, TRACE_GENERATOR,
+      "--pattern", pattern,
+      "--ratio", "0.8",
+      "--num_reqs", str(args.num_reqs),
+      "--type", "ramulatorv2",
+      "--output", trace_file
+    ])
+  return trace_file
+
+
+def simulate(binary, config_file, trace_file, scheduler, output_dir):
+  """
+  Runs one simulation, and returns the paths to its outputs: the standard output (the statistics) followed by the per-channel command traces.
+  """
+  with open(config_file) as f:
+    config = yaml.load(f, Loader=yaml.FullLoader)
+  config["Frontend"]["path"] = trace_file
+  if scheduler:
+    config["MemorySystem"]["Controller"]["Scheduler"]["impl"] = scheduler
+  for plugin in config["MemorySystem"]["Controller"]["plugins"]:
+    if plugin["ControllerPlugin"]["impl"] == "TraceRecorder":
+      plugin["ControllerPlugin"]["path"] = os.path.join(output_dir, "cmds")
+
+  os.makedirs(output_dir, exist_ok = True)
+  for cmd_trace in glob.glob(os.path.join(output_dir, "cmds.ch*")):
+    os.remove(cmd_trace)
+
+  stats_file = os.path.join(output_dir, "stdout.txt")
+  print(f"Running {binary} on {trace_file}...")
+  with open(stats_file, "w") as f:
+    subprocess.run([binary, "--config", yaml.dump(config)], check = True, stdout = f, cwd = output_dir)
+
+  return [stats_file] + sorted(glob.glob(os.path.join(output_dir, "cmds.ch*")))
+
+
+def same_stdout(file_a, file_b, scheduler_a, scheduler_b):
+  """
+  Compares the standard outputs of two runs, except for the names of their schedulers in the statistics.
+  """
+  with open(file_a) as f_a, open(file_b) as f_b:
+    return f_a.read().replace(f"impl: {scheduler_a}\n", "impl: <scheduler>\n") == f_b.read().replace(f"impl: {scheduler_b}\n", "impl: <scheduler>\n")
+
+
+def compare_outputs(outputs_a, outputs_b, scheduler_a, scheduler_b):
+  """
+  Returns the outputs that are missing from either run or differ between the runs.
+  """
+  names_a = [os.path.basename(f) for f in outputs_a]
+  names_b = [os.path.basename(f) for f in outputs_b]
+  diffs = sorted(set(names_a) ^ set(names_b))
+  for f_a, f_b in zip(outputs_a, outputs_b):
+    if os.path.basename(f_a) != os.path.basename(f_b):
+      continue
+    if scheduler_a != scheduler_b and f_a == outputs_a[0]:
+      same = same_stdout(f_a, f_b, scheduler_a, scheduler_b)
+    else:
+      same = filecmp.cmp(f_a, f_b, shallow = False)
+    if not same:
+      diffs.append(os.path.basename(f_a))
+  return diffs
+
+
+def report(name, diffs, outputs):
+  if diffs:
+    print(f"[DIFF]  {name}: {', '.join(diffs)}")
+  else:
+    print(f"[MATCH] {name}: {len(outputs) - 1} command trace(s) and the statistics")
+  return len(diffs) > 0
+
+
+def main():
+  args = parse_arg()
+  args.work_dir = os.path.abspath(args.work_dir)
+
+  traces = {pattern: generate_trace(pattern, args) for pattern in args.patterns}
+  revs = [args.base_rev, args.head_rev] if args.base_rev else [args.head_rev]
+  revisions = [build_revision(rev, args) for rev in revs]
+  schedulers = args.schedulers or [None]
+
+  num_diffs = 0
+  for config_file in args.configs:
+    config_name = os.path.splitext(os.path.basename(config_file))[0]
+    for pattern, trace_file in traces.items():
+      outputs = {}
+      for sha, binary in revisions:
+        for scheduler in schedulers:
+          run_name = f"{config_name}_{pattern}" + (f"_{scheduler}" if scheduler else "")
+          output_dir = os.path.join(args.work_dir, "output", sha, run_name)
+          outputs[sha, scheduler] = simulate(binary, config_file, trace_file, scheduler, output_dir)
+
+      # Every scheduler between the revisions
+      if len(revisions) == 2:
+        (base_sha, _), (head_sha, _) = revisions
+        for scheduler in schedulers:
+          name = f"{config_name} {pattern}" + (f" {scheduler}" if scheduler else "") + f" ({base_sha} vs {head_sha})"
+          diffs = compare_outputs(outputs[base_sha, scheduler], outputs[head_sha, scheduler], scheduler, scheduler)
+          num_diffs += report(name, diffs, outputs[head_sha, scheduler])
+
+      # Every scheduler against the first one within each revision
+      for sha, _ in revisions:
+        for scheduler in schedulers[1:]:
+          name = f"{config_name} {pattern} {sha} ({schedulers[0]} vs {scheduler})"
+          diffs = compare_outputs(outputs[sha, schedulers[0]], outputs[sha, scheduler], schedulers[0], scheduler)
+          num_diffs += report(name, diffs, outputs[sha, scheduler])
+
+  if num_diffs:
+    print(f"{num_diffs} comparison(s) differ.")
+    exit(1)
+  print("All comparisons match.")
+
+
+if __name__ == "__main__":
+  main()